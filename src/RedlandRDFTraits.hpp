@@ -2,6 +2,8 @@
 #define REDLAND_RDF_TRAITS_HPP_INCLUDED
 
 #include "redland.hpp"
+#include <cerrno>
+#include <cstdlib>
 #include <memory>
 #include <vector>
 #include <string>
@@ -27,27 +29,28 @@ struct Context
     const std::string &path;
     Cache *cache;
     const void *user_data;
-
+    /** Optional allocator for blank nodes, librdf generates identifiers when null */
+    Redland::BlankNodeAllocator *blank_nodes;
 
     Context(Redland::World &world, Redland::Namespaces &namespaces, Redland::Model &model, const std::string &base_path,
             const std::string &path, Cache *cache = 0, const void *user_data = 0)
-        : world(world), namespaces(namespaces), model(model), base_path(base_path), path(path), cache(cache), user_data(user_data)
+        : world(world), namespaces(namespaces), model(model), base_path(base_path), path(path), cache(cache), user_data(user_data), blank_nodes(0)
     {
     }
 
     Context(Redland::World &world, Redland::Namespaces &namespaces, Redland::Model &model, const std::string &path,
             Cache *cache = 0, const void *user_data = 0)
-        : world(world), namespaces(namespaces), model(model), base_path(path), path(path), cache(cache), user_data(user_data)
+        : world(world), namespaces(namespaces), model(model), base_path(path), path(path), cache(cache), user_data(user_data), blank_nodes(0)
     {
     }
 
     Context(const Context &ctx)
-        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data)
+        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data), blank_nodes(ctx.blank_nodes)
     {
     }
 
     Context(const Context &ctx, const std::string &path)
-        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data)
+        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data), blank_nodes(ctx.blank_nodes)
     {
     }
 };
@@ -118,6 +121,13 @@ inline bool isNodeExists(Redland::Model &model, const Redland::Node &node)
     return false;
 }
 
+inline Node makeBlankNode(const Context &ctx)
+{
+    if (ctx.blank_nodes)
+        return ctx.blank_nodes->make_node(ctx.world);
+    return Redland::Node::make_blank_node(ctx.world);
+}
+
 template<class T>
 inline bool isValidValue(const T &value)
 {
@@ -272,7 +282,7 @@ Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType,
     const PathType thatPathType = pathTypeOf(ctx, value);
     if (thatPathType == NO_PATH)
     {
-        Redland::Node thatNode(Redland::Node::make_blank_node(ctx.world));
+        Redland::Node thatNode(makeBlankNode(ctx));
         return thatNode;
     }
     else
@@ -313,7 +323,7 @@ Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memb
     const PathType thatPathType = pathTypeOf(ctx, value);
     if (thatPathType == NO_PATH)
     {
-        Redland::Node thatNode(Redland::Node::make_blank_node(ctx.world));
+        Redland::Node thatNode(makeBlankNode(ctx));
         if (!isNodeExists(ctx.model, thatNode))
             toRDF(ctx, thatNode, value);
         return thatNode;
@@ -357,7 +367,7 @@ Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memb
 template<class T>
 Node toRDF(const Context &ctx, const T &value)
 {
-    Redland::Node valueNode = Redland::Node::make_blank_node(ctx.world);
+    Redland::Node valueNode = makeBlankNode(ctx);
     return toRDF(ctx, valueNode, value);
 }
 
@@ -375,7 +385,7 @@ inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::shared_ptr
     else
     {
         if (!thisNode.is_blank())
-            thisNode = Redland::Node::make_blank_node(ctx.world);
+            thisNode = makeBlankNode(ctx);
         return thisNode;
     }
 }
@@ -424,11 +434,15 @@ inline bool fromRDF(const Context &ctx, const NodeRef _this0, double &value)
 {
     if (_this0.is_literal())
     {
-        try {
-            value = std::stod(_this0.get_literal_value());
-            return true;
-        } catch (...)
+        // literal values are NUL terminated, parse them in place
+        const char *s = _this0.view().literal_value().data();
+        char *end = 0;
+        errno = 0;
+        const double result = std::strtod(s, &end);
+        if (end != s && errno != ERANGE)
         {
+            value = result;
+            return true;
         }
     }
     return false;
@@ -439,11 +453,15 @@ inline bool fromRDF(const Context &ctx, const NodeRef _this0, float &value)
 {
     if (_this0.is_literal())
     {
-        try {
-            value = std::stof(_this0.get_literal_value());
-            return true;
-        } catch (...)
+        // literal values are NUL terminated, parse them in place
+        const char *s = _this0.view().literal_value().data();
+        char *end = 0;
+        errno = 0;
+        const float result = std::strtof(s, &end);
+        if (end != s && errno != ERANGE)
         {
+            value = result;
+            return true;
         }
     }
     return false;
@@ -454,7 +472,8 @@ inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string &value
 {
     if (_this0.is_literal())
     {
-        value = _this0.get_literal_value();
+        const Redland::StringRef literal = _this0.view().literal_value();
+        value.assign(literal.data(), literal.size());
         return true;
     }
     return false;
@@ -0,0 +1,65 @@
+/*
+ * blank_tag.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef BLANK_TAG_HPP_INCLUDED
+#define BLANK_TAG_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+/**
+ * Random tags put into generated blank node identifiers, so identifiers
+ * of different runs and of different generators never collide.
+ */
+struct BlankTag
+{
+    enum { length = 12 };
+
+    /** Seed which differs between runs and between calls within a run */
+    static uint64_t random_seed()
+    {
+        uint64_t seed = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        try
+        {
+            std::random_device device;
+            seed ^= (static_cast<uint64_t>(device()) << 32) ^ device();
+        }
+        catch (...)
+        {
+            // the clock alone still differs between runs
+        }
+        // calls at the same clock tick still differ
+        static std::atomic<uint64_t> num_calls(0);
+        return seed ^ (num_calls.fetch_add(1, std::memory_order_relaxed) + 1) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    /** Write length hex digits derived from seed to out, not null terminated */
+    static void format(uint64_t seed, char *out)
+    {
+        // splitmix64 finalizer, so that close seeds give unrelated tags
+        seed ^= seed >> 30;
+        seed *= 0xBF58476D1CE4E5B9ULL;
+        seed ^= seed >> 27;
+        seed *= 0x94D049BB133111EBULL;
+        seed ^= seed >> 31;
+        static const char hex[] = "0123456789abcdef";
+        for (int i = 0; i < length; ++i)
+            out[i] = hex[(seed >> (4 * i)) & 0xF];
+    }
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif /* BLANK_TAG_HPP_INCLUDED */
@@ -0,0 +1,650 @@
+/*
+ * ntriples_parser.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_NTRIPLES_PARSER_HPP_INCLUDED
+#define RDW_NTRIPLES_PARSER_HPP_INCLUDED
+
+#include "redland.hpp"
+#include "ntriples_simd.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Term as seen by an N-Triples sink. Strings point either into the parsed
+ * input or into the parser's arena and are only valid during the sink call.
+ */
+struct NTriplesTerm
+{
+    enum Type
+    {
+        NONE = 0,
+        URI,
+        BLANK,
+        LITERAL
+    };
+
+    Type type;
+    StringRef value;
+    StringRef datatype;
+    StringRef language;
+
+    NTriplesTerm() : type(NONE) { }
+};
+
+/**
+ * Block arena for unescaped term strings. reset() makes all blocks
+ * available again without freeing them.
+ */
+class NTriplesArena
+{
+public:
+
+    explicit NTriplesArena(std::size_t block_size = 64 * 1024)
+        : block_size_(block_size)
+        , current_(0)
+        , used_(0)
+    { }
+
+    char * allocate(std::size_t n)
+    {
+        while (current_ < blocks_.size())
+        {
+            std::vector<char> &block = blocks_[current_];
+            if (used_ + n <= block.size())
+            {
+                char *result = block.data() + used_;
+                used_ += n;
+                return result;
+            }
+            ++current_;
+            used_ = 0;
+        }
+        blocks_.push_back(std::vector<char>(std::max(n, block_size_)));
+        current_ = blocks_.size() - 1;
+        used_ = n;
+        return blocks_.back().data();
+    }
+
+    void reset()
+    {
+        current_ = 0;
+        used_ = 0;
+    }
+
+private:
+    std::size_t block_size_;
+    std::vector<std::vector<char> > blocks_;
+    std::size_t current_;
+    std::size_t used_;
+};
+
+/**
+ * Native N-Triples / N-Quads parser.
+ *
+ * Line ends, IRI ends and literal ends are located with the SSE2/AVX2
+ * kernels from ntriples_simd.hpp. Terms without escapes are passed to the
+ * sink as views into the input, only escaped terms are decoded into the
+ * arena. Sink is any callable with the signature
+ *
+ *   bool (const NTriplesTerm &subject, const NTriplesTerm &predicate,
+ *         const NTriplesTerm &object, const NTriplesTerm &graph)
+ *
+ * where graph has type NONE for triples. Returning false stops parsing.
+ */
+template <class Sink>
+class NTriplesParser
+{
+public:
+
+    explicit NTriplesParser(Sink &sink, bool nquads = false)
+        : sink_(sink)
+        , nquads_(nquads)
+        , line_(0)
+        , num_statements_(0)
+        , failed_(false)
+        , pending_cr_(false)
+    { }
+
+    NTriplesParser(const NTriplesParser &) = delete;
+    NTriplesParser & operator=(const NTriplesParser &) = delete;
+
+    /** Line number of the last parsed line, starting with 1 */
+    std::size_t line() const { return line_; }
+
+    std::size_t num_statements() const { return num_statements_; }
+
+    /** Error message of the failed parse, empty on success */
+    const std::string & error() const { return error_; }
+
+    /**
+     * Parse complete document held in memory.
+     */
+    bool parse(const char *data, std::size_t length)
+    {
+        reset();
+        return parse_chunk(data, length, true);
+    }
+
+    bool parse(const std::string &data)
+    {
+        return parse(data.data(), data.size());
+    }
+
+    /**
+     * Parse next chunk of a document, a partial last line is kept until
+     * the next call. is_end must be set for the last chunk.
+     */
+    bool parse_chunk(const char *data, std::size_t length, bool is_end)
+    {
+        if (failed_)
+            return false;
+
+        // the \n of a \r\n line end split between two chunks
+        if (pending_cr_ && length != 0)
+        {
+            pending_cr_ = false;
+            if (*data == '\n')
+            {
+                ++data;
+                --length;
+            }
+        }
+
+        const char *begin = data;
+        const char *end = data + length;
+        if (!carry_.empty())
+        {
+            const std::size_t n = NTriplesDetail::find2(reinterpret_cast<const unsigned char *>(data),
+                                                        length, '\n', '\r');
+            carry_.append(data, n);
+            if (n == length && !is_end)
+                return true;
+            data += n;
+            line_++;
+            if (!parse_line(carry_.data(), carry_.data() + carry_.size()))
+                return false;
+            carry_.clear();
+            data = skip_line_end(data, end);
+        }
+
+        // last line end in this chunk, the rest goes to the carry buffer
+        const char *last = end;
+        if (!is_end)
+        {
+            while (last != data && last[-1] != '\n' && last[-1] != '\r')
+                --last;
+        }
+
+        if (!parse_lines(data, last))
+            return false;
+
+        if (last != end)
+            carry_.assign(last, end - last);
+        else
+            pending_cr_ = !is_end && end != begin && end[-1] == '\r';
+        return true;
+    }
+
+    bool parse_file(FILE *handle, std::size_t chunk_size = 4 * 1024 * 1024)
+    {
+        reset();
+        std::vector<char> buffer(chunk_size ? chunk_size : 4096);
+        for (;;)
+        {
+            const std::size_t n = fread(buffer.data(), 1, buffer.size(), handle);
+            const bool is_end = n < buffer.size();
+            if (is_end && ferror(handle))
+                return fail("read error");
+            if (!parse_chunk(buffer.data(), n, is_end))
+                return false;
+            if (is_end)
+                return true;
+        }
+    }
+
+    bool parse_file(const char *filename)
+    {
+        FILE *handle = fopen(filename, "rb");
+        if (!handle)
+        {
+            reset();
+            return fail(std::string("could not open file ") + filename);
+        }
+        const bool result = parse_file(handle);
+        fclose(handle);
+        return result;
+    }
+
+private:
+
+    void reset()
+    {
+        line_ = 0;
+        num_statements_ = 0;
+        failed_ = false;
+        error_.clear();
+        carry_.clear();
+        pending_cr_ = false;
+    }
+
+    bool fail(const std::string &message)
+    {
+        failed_ = true;
+        std::ostringstream msgs;
+        msgs << "line " << line_ << ": " << message;
+        error_ = msgs.str();
+        return false;
+    }
+
+    static const char * skip_line_end(const char *p, const char *end)
+    {
+        if (p != end && *p == '\r')
+            ++p;
+        if (p != end && *p == '\n')
+            ++p;
+        return p;
+    }
+
+    static const char * skip_space(const char *p, const char *end)
+    {
+        while (p != end && (*p == ' ' || *p == '\t'))
+            ++p;
+        return p;
+    }
+
+    bool parse_lines(const char *p, const char *end)
+    {
+        while (p != end)
+        {
+            const std::size_t n = NTriplesDetail::find2(reinterpret_cast<const unsigned char *>(p),
+                                                        end - p, '\n', '\r');
+            line_++;
+            if (!parse_line(p, p + n))
+                return false;
+            p = skip_line_end(p + n, end);
+        }
+        return true;
+    }
+
+    bool parse_line(const char *p, const char *end)
+    {
+        p = skip_space(p, end);
+        if (p == end || *p == '#')
+            return true;
+
+        arena_.reset();
+        NTriplesTerm subject, predicate, object, graph;
+
+        if (!parse_term(p, end, subject))
+            return false;
+        p = skip_space(p, end);
+        if (!parse_term(p, end, predicate))
+            return false;
+        p = skip_space(p, end);
+        if (!parse_term(p, end, object))
+            return false;
+        p = skip_space(p, end);
+
+        if (nquads_ && p != end && *p != '.')
+        {
+            if (!parse_term(p, end, graph))
+                return false;
+            if (graph.type == NTriplesTerm::LITERAL)
+                return fail("literal as graph name");
+            p = skip_space(p, end);
+        }
+
+        if (subject.type == NTriplesTerm::LITERAL)
+            return fail("literal as subject");
+        if (predicate.type != NTriplesTerm::URI)
+            return fail("predicate is not an IRI");
+
+        if (p == end || *p != '.')
+            return fail("expected '.' at end of statement");
+        p = skip_space(p + 1, end);
+        if (p != end && *p != '#')
+            return fail("trailing characters after '.'");
+
+        num_statements_++;
+        if (!sink_(subject, predicate, object, graph))
+            return fail("aborted by statement sink");
+        return true;
+    }
+
+    bool parse_term(const char *&p, const char *end, NTriplesTerm &term)
+    {
+        if (p == end)
+            return fail("unexpected end of line");
+        switch (*p)
+        {
+            case '<':
+                term.type = NTriplesTerm::URI;
+                return parse_iri(p, end, term.value);
+            case '_':
+                term.type = NTriplesTerm::BLANK;
+                return parse_blank(p, end, term.value);
+            case '"':
+                term.type = NTriplesTerm::LITERAL;
+                if (!parse_literal(p, end, term.value))
+                    return false;
+                if (p != end && *p == '@')
+                    return parse_language(p, end, term.language);
+                if (p + 1 < end && p[0] == '^' && p[1] == '^')
+                {
+                    p += 2;
+                    if (p == end || *p != '<')
+                        return fail("expected datatype IRI after '^^'");
+                    return parse_iri(p, end, term.datatype);
+                }
+                return true;
+            default:
+                return fail(std::string("unexpected character '") + *p + "'");
+        }
+    }
+
+    bool parse_iri(const char *&p, const char *end, StringRef &value)
+    {
+        const unsigned char *start = reinterpret_cast<const unsigned char *>(p + 1);
+        const std::size_t length = end - (p + 1);
+        // characters excluded from IRIREF, including '>' and '\'
+        const std::size_t n = NTriplesDetail::scan(start, length, true);
+        if (n == length)
+            return fail("unterminated IRI");
+        if (start[n] == '>')
+        {
+            value = StringRef(p + 1, n);
+            p += n + 2;
+            return true;
+        }
+        if (start[n] != '\\')
+            return fail("invalid character in IRI");
+
+        // slow path, IRIs only allow \u and \U escapes
+        char *out = arena_.allocate(length);
+        std::memcpy(out, start, n);
+        char *dest = out + n;
+        const char *q = p + 1 + n;
+        while (q != end && *q != '>')
+        {
+            if (*q == '\\')
+            {
+                if (q + 1 == end || (q[1] != 'u' && q[1] != 'U'))
+                    return fail("invalid escape in IRI");
+                if (!decode_uchar(q, end, dest))
+                    return false;
+            }
+            else if (NTriplesDetail::needs_escape(static_cast<unsigned char>(*q), true))
+                return fail("invalid character in IRI");
+            else
+                *dest++ = *q++;
+        }
+        if (q == end)
+            return fail("unterminated IRI");
+        value = StringRef(out, dest - out);
+        p = q + 1;
+        return true;
+    }
+
+    bool parse_blank(const char *&p, const char *end, StringRef &value)
+    {
+        if (p + 2 > end || p[1] != ':')
+            return fail("expected '_:' for blank node");
+        const char *start = p + 2;
+        const char *q = start;
+        while (q != end && *q != ' ' && *q != '\t' && *q != '<' && *q != '"' && *q != '#')
+            ++q;
+        // label may contain but not end with '.', e.g. "_:b1."
+        while (q != start && q[-1] == '.')
+            --q;
+        if (q == start)
+            return fail("empty blank node label");
+        value = StringRef(start, q - start);
+        p = q;
+        return true;
+    }
+
+    bool parse_literal(const char *&p, const char *end, StringRef &value)
+    {
+        const unsigned char *start = reinterpret_cast<const unsigned char *>(p + 1);
+        const std::size_t length = end - (p + 1);
+        const std::size_t n = NTriplesDetail::find2(start, length, '"', '\\');
+        if (n == length)
+            return fail("unterminated literal");
+        if (start[n] == '"')
+        {
+            value = StringRef(p + 1, n);
+            p += n + 2;
+            return true;
+        }
+
+        // slow path, decoded text is never longer than its escaped form
+        char *out = arena_.allocate(length);
+        std::memcpy(out, start, n);
+        char *dest = out + n;
+        const char *q = p + 1 + n;
+        while (q != end)
+        {
+            const std::size_t run = NTriplesDetail::find2(reinterpret_cast<const unsigned char *>(q),
+                                                          end - q, '"', '\\');
+            std::memcpy(dest, q, run);
+            dest += run;
+            q += run;
+            if (q == end || *q == '"')
+                break;
+            if (q + 1 == end)
+                return fail("unterminated literal");
+            char c = 0;
+            switch (q[1])
+            {
+                case 't': c = '\t'; break;
+                case 'b': c = '\b'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 'f': c = '\f'; break;
+                case '"': c = '"'; break;
+                case '\'': c = '\''; break;
+                case '\\': c = '\\'; break;
+                case 'u':
+                case 'U':
+                    if (!decode_uchar(q, end, dest))
+                        return false;
+                    continue;
+                default:
+                    return fail("invalid escape in literal");
+            }
+            *dest++ = c;
+            q += 2;
+        }
+        if (q == end)
+            return fail("unterminated literal");
+        value = StringRef(out, dest - out);
+        p = q + 1;
+        return true;
+    }
+
+    bool parse_language(const char *&p, const char *end, StringRef &value)
+    {
+        const char *start = ++p;
+        const char *q = start;
+        while (q != end && ((*q >= 'a' && *q <= 'z') || (*q >= 'A' && *q <= 'Z')))
+            ++q;
+        if (q == start)
+            return fail("empty language tag");
+        while (q != end && *q == '-')
+        {
+            const char *subtag = ++q;
+            while (q != end && ((*q >= 'a' && *q <= 'z') || (*q >= 'A' && *q <= 'Z') || (*q >= '0' && *q <= '9')))
+                ++q;
+            if (q == subtag)
+                return fail("empty language subtag");
+        }
+        value = StringRef(start, q - start);
+        p = q;
+        return true;
+    }
+
+    /**
+     * Decode \uXXXX or \UXXXXXXXX at q to UTF-8 at dest, advances both.
+     */
+    bool decode_uchar(const char *&q, const char *end, char *&dest)
+    {
+        const int digits = q[1] == 'u' ? 4 : 8;
+        if (end - q < 2 + digits)
+            return fail("truncated unicode escape");
+        unsigned long cp = 0;
+        for (int i = 0; i < digits; ++i)
+        {
+            const char c = q[2 + i];
+            cp <<= 4;
+            if (c >= '0' && c <= '9')
+                cp |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                cp |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                cp |= c - 'A' + 10;
+            else
+                return fail("invalid hex digit in unicode escape");
+        }
+        if (cp > 0x10FFFF)
+            return fail("unicode escape out of range");
+
+        if (cp < 0x80)
+            *dest++ = static_cast<char>(cp);
+        else if (cp < 0x800)
+        {
+            *dest++ = static_cast<char>(0xC0 | (cp >> 6));
+            *dest++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            *dest++ = static_cast<char>(0xE0 | (cp >> 12));
+            *dest++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *dest++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            *dest++ = static_cast<char>(0xF0 | (cp >> 18));
+            *dest++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *dest++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *dest++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        q += 2 + digits;
+        return true;
+    }
+
+    Sink &sink_;
+    bool nquads_;
+    std::size_t line_;
+    std::size_t num_statements_;
+    bool failed_;
+    bool pending_cr_;
+    std::string error_;
+    std::string carry_;
+    NTriplesArena arena_;
+};
+
+/**
+ * Sink adding parsed statements to a model, quads go to their context.
+ */
+class NTriplesModelSink
+{
+public:
+
+    NTriplesModelSink(const World &world, Model &model)
+        : world_(world)
+        , model_(model)
+    { }
+
+    bool operator()(const NTriplesTerm &subject, const NTriplesTerm &predicate,
+                    const NTriplesTerm &object, const NTriplesTerm &graph)
+    {
+        Node s(make_node(subject));
+        Node p(make_node(predicate));
+        Node o(make_node(object));
+        if (!s.is_valid() || !p.is_valid() || !o.is_valid())
+            return false;
+        const StatementRef statement(world_, s.c_obj(), p.c_obj(), o.c_obj());
+        if (graph.type == NTriplesTerm::NONE)
+            return model_.add_statement(statement);
+        Node context(make_node(graph));
+        return context.is_valid() && model_.add_statement(context, statement);
+    }
+
+private:
+
+    librdf_node * make_node(const NTriplesTerm &term)
+    {
+        const unsigned char *value = reinterpret_cast<const unsigned char *>(term.value.data());
+        switch (term.type)
+        {
+            case NTriplesTerm::URI:
+                return librdf_new_node_from_counted_uri_string(world_.c_obj(), value, term.value.size());
+            case NTriplesTerm::LITERAL:
+            {
+                librdf_uri *datatype = 0;
+                if (!term.datatype.empty())
+                {
+                    // typed data usually repeats the same few datatypes
+                    if (!datatype_.is_valid() || StringRef(datatype_string_) != term.datatype)
+                    {
+                        datatype_string_.assign(term.datatype.data(), term.datatype.size());
+                        datatype_ = Uri(world_, datatype_string_);
+                    }
+                    datatype = datatype_.c_obj();
+                }
+                return librdf_new_node_from_typed_counted_literal(world_.c_obj(),
+                    value, term.value.size(),
+                    term.language.empty() ? 0 : term.language.data(), term.language.size(),
+                    datatype);
+            }
+            case NTriplesTerm::BLANK:
+                return librdf_new_node_from_counted_blank_identifier(world_.c_obj(), value, term.value.size());
+            default:
+                return 0;
+        }
+    }
+
+    const World &world_;
+    Model &model_;
+    Uri datatype_;
+    std::string datatype_string_;
+};
+
+/**
+ * Parse N-Triples (or N-Quads when nquads is true) file into model.
+ */
+inline bool parse_ntriples_into_model(const World &world, Model &model, const char *filename,
+                                      bool nquads = false, std::string *error = 0)
+{
+    NTriplesModelSink sink(world, model);
+    NTriplesParser<NTriplesModelSink> parser(sink, nquads);
+    const bool result = parser.parse_file(filename);
+    if (error)
+        *error = parser.error();
+    return result;
+}
+
+inline bool parse_ntriples_string_into_model(const World &world, Model &model, const std::string &data,
+                                             bool nquads = false, std::string *error = 0)
+{
+    NTriplesModelSink sink(world, model);
+    NTriplesParser<NTriplesModelSink> parser(sink, nquads);
+    const bool result = parser.parse(data);
+    if (error)
+        *error = parser.error();
+    return result;
+}
+
+} // namespace Redland
+
+#endif /* RDW_NTRIPLES_PARSER_HPP_INCLUDED */
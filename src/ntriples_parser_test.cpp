@@ -0,0 +1,175 @@
+/*
+ * ntriples_parser_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "redland.hpp"
+#include "ntriples_parser.hpp"
+#include "test_check.hpp"
+
+/**
+ * Conformance test of NTriplesParser against raptor's ntriples parser.
+ * Every input is parsed by both, whole and in chunks of several sizes, and
+ * the resulting statements must be equal. Blank node labels are compared
+ * by position only, since raptor may rename them. Files given on the
+ * command line are compared as well.
+ */
+
+using namespace Redland;
+
+static const char * const valid_documents[] = {
+    "<http://example.org/s> <http://example.org/p> <http://example.org/o> .\n",
+    "<http://example.org/s> <http://example.org/p> \"plain\" .\n"
+    "<http://example.org/s> <http://example.org/p> \"chat\"@fr .\n"
+    "<http://example.org/s> <http://example.org/p> \"1\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n",
+    "# comment\n\n   \t\n<http://example.org/s> <http://example.org/p> <http://example.org/o> . # trailing\n",
+    "_:a <http://example.org/p> _:b .\n_:b <http://example.org/p> _:a .\n",
+    "<http://example.org/s> <http://example.org/p> \"tab\\tquote\\\"backslash\\\\nl\\nret\\r\" .\n",
+    "<http://example.org/s> <http://example.org/p> \"\\u00E9\\U0001F600\" .\n",
+    "<http://example.org/\\u00E9> <http://example.org/p> <http://example.org/o> .\n",
+    "<http://example.org/s> <http://example.org/p> <http://example.org/o1> .\r\n"
+    "\r\n"
+    "<http://example.org/s> <http://example.org/p> <http://example.org/o2> .\r"
+    "<http://example.org/s> <http://example.org/p> <http://example.org/o3> .",
+    "<http://example.org/s>\t<http://example.org/p>\t\"\xC3\xA9t\xC3\xA9\"  .  \n",
+};
+
+static const char * const invalid_documents[] = {
+    "<http://example.org/s> <http://example.org/p> <http://example.org/o>\n",
+    "<http://example.org/s> <http://example.org/p> <http://example.org/o .\n",
+    "<http://example.org/s> <http://example.org/p> \"open .\n",
+    "\"literal\" <http://example.org/p> <http://example.org/o> .\n",
+    "<http://example.org/s> <http://example.org/p> \"bad\\q\" .\n",
+};
+
+static std::string term_string(librdf_node *node)
+{
+    switch (librdf_node_get_type(node))
+    {
+        case LIBRDF_NODE_TYPE_RESOURCE:
+            return "<" + std::string(reinterpret_cast<const char *>(
+                librdf_uri_as_string(librdf_node_get_uri(node)))) + ">";
+        case LIBRDF_NODE_TYPE_LITERAL:
+        {
+            size_t length = 0;
+            const unsigned char *value = librdf_node_get_literal_value_as_counted_string(node, &length);
+            std::string result = "\"" + std::string(reinterpret_cast<const char *>(value), length) + "\"";
+            if (const char *language = librdf_node_get_literal_value_language(node))
+                result += "@" + std::string(language);
+            if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                result += "^^<" + std::string(reinterpret_cast<const char *>(librdf_uri_as_string(datatype))) + ">";
+            return result;
+        }
+        case LIBRDF_NODE_TYPE_BLANK:
+            return "_:";
+        default:
+            return "?";
+    }
+}
+
+/** Sorted statements of model with blank labels removed */
+static std::vector<std::string> statements(const Model &model)
+{
+    std::vector<std::string> result;
+    Stream stream(model.as_stream());
+    for (; stream.is_valid() && !stream.is_end(); stream.next())
+    {
+        librdf_statement *statement = librdf_stream_get_object(stream.c_obj());
+        result.push_back(term_string(librdf_statement_get_subject(statement)) + " " +
+                         term_string(librdf_statement_get_predicate(statement)) + " " +
+                         term_string(librdf_statement_get_object(statement)));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static bool parse_native(const World &world, Model &model, const std::string &data, std::size_t chunk_size)
+{
+    NTriplesModelSink sink(world, model);
+    NTriplesParser<NTriplesModelSink> parser(sink);
+    if (!chunk_size)
+        return parser.parse(data);
+    for (std::size_t i = 0; i < data.size(); i += chunk_size)
+    {
+        const std::size_t n = std::min(chunk_size, data.size() - i);
+        if (!parser.parse_chunk(data.data() + i, n, i + n == data.size()))
+            return false;
+    }
+    return data.empty() ? parser.parse_chunk(data.data(), 0, true) : true;
+}
+
+static bool parse_raptor(const World &world, Model &model, const std::string &data)
+{
+    Parser parser(world, "ntriples");
+    return parser.parse_into_model(data, Uri(world, "http://example.org/base"), model);
+}
+
+enum Validity { INVALID, VALID, UNKNOWN };
+
+static void compare(const World &world, const std::string &name, const std::string &data, Validity validity)
+{
+    Storage raptor_storage(world, "hashes", 0, "hash-type='memory'");
+    Model raptor_model(world, raptor_storage, 0);
+    const bool raptor_ok = parse_raptor(world, raptor_model, data);
+    if (validity != UNKNOWN && raptor_ok != (validity == VALID))
+        std::cerr << name << ": raptor " << (raptor_ok ? "accepts" : "rejects") << " the input" << std::endl;
+    const std::vector<std::string> expected = statements(raptor_model);
+
+    static const std::size_t chunk_sizes[] = { 0, 1, 2, 3, 7, 64 };
+    for (std::size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++i)
+    {
+        Storage storage(world, "hashes", 0, "hash-type='memory'");
+        Model model(world, storage, 0);
+        const bool ok = parse_native(world, model, data, chunk_sizes[i]);
+        if (ok != raptor_ok || (ok && statements(model) != expected))
+        {
+            std::cerr << name << ", chunk size " << chunk_sizes[i] << ": result differs from raptor" << std::endl;
+            ++test_failures();
+        }
+    }
+}
+
+static bool read_file(const char *filename, std::string &data)
+{
+    FILE *handle = fopen(filename, "rb");
+    if (!handle)
+        return false;
+    char buffer[64 * 1024];
+    std::size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), handle)) > 0)
+        data.append(buffer, n);
+    fclose(handle);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    World world;
+
+    for (std::size_t i = 0; i < sizeof(valid_documents) / sizeof(valid_documents[0]); ++i)
+        compare(world, "valid document " + std::to_string(i), valid_documents[i], VALID);
+    for (std::size_t i = 0; i < sizeof(invalid_documents) / sizeof(invalid_documents[0]); ++i)
+        compare(world, "invalid document " + std::to_string(i), invalid_documents[i], INVALID);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string data;
+        if (!read_file(argv[i], data))
+        {
+            std::cerr << "could not read " << argv[i] << std::endl;
+            ++test_failures();
+            continue;
+        }
+        compare(world, argv[i], data, UNKNOWN);
+    }
+
+    return test_exit_status("comparisons");
+}
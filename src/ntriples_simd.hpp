@@ -0,0 +1,225 @@
+/*
+ * ntriples_simd.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_NTRIPLES_SIMD_HPP_INCLUDED
+#define RDW_NTRIPLES_SIMD_HPP_INCLUDED
+
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define RDW_NTRIPLES_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Redland
+{
+
+namespace NTriplesDetail
+{
+
+/**
+ * Bytes that must be escaped inside a literal (quote, backslash and
+ * control characters) or inside an IRI (characters excluded by IRIREF).
+ */
+inline bool needs_escape(unsigned char c, bool iri)
+{
+    if (iri)
+    {
+        switch (c)
+        {
+            case '<': case '>': case '"': case '{': case '}':
+            case '|': case '^': case '`': case '\\':
+                return true;
+            default:
+                return c <= 0x20;
+        }
+    }
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+/**
+ * Returns position of the first byte needing an escape, or length.
+ */
+inline std::size_t scan_scalar(const unsigned char *p, std::size_t length, bool iri)
+{
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        if (needs_escape(p[i], iri))
+            return i;
+    }
+    return length;
+}
+
+#ifdef RDW_NTRIPLES_X86
+
+__attribute__((target("sse2")))
+inline std::size_t scan_sse2(const unsigned char *p, std::size_t length, bool iri)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(iri ? 0x20 : 0x1F);
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        // unsigned x <= ctrl_max
+        __m128i m = _mm_cmpeq_epi8(_mm_max_epu8(x, ctrl_max), ctrl_max);
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(x, quote));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(x, backslash));
+        if (iri)
+        {
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('<')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('>')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('{')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('}')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('|')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('^')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('`')));
+        }
+        const int mask = _mm_movemask_epi8(m);
+        if (mask)
+            return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    return i + scan_scalar(p + i, length - i, iri);
+}
+
+__attribute__((target("avx2")))
+inline std::size_t scan_avx2(const unsigned char *p, std::size_t length, bool iri)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i ctrl_max = _mm256_set1_epi8(iri ? 0x20 : 0x1F);
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        __m256i m = _mm256_cmpeq_epi8(_mm256_max_epu8(x, ctrl_max), ctrl_max);
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, quote));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, backslash));
+        if (iri)
+        {
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('<')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('>')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('{')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('}')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('|')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('^')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('`')));
+        }
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(m));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + scan_sse2(p + i, length - i, iri);
+}
+
+#endif /* RDW_NTRIPLES_X86 */
+
+/**
+ * Returns position of the first byte equal to a or b, or length.
+ */
+inline std::size_t find2_scalar(const unsigned char *p, std::size_t length, unsigned char a, unsigned char b)
+{
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        if (p[i] == a || p[i] == b)
+            return i;
+    }
+    return length;
+}
+
+#ifdef RDW_NTRIPLES_X86
+
+__attribute__((target("sse2")))
+inline std::size_t find2_sse2(const unsigned char *p, std::size_t length, unsigned char a, unsigned char b)
+{
+    const __m128i va = _mm_set1_epi8(static_cast<char>(a));
+    const __m128i vb = _mm_set1_epi8(static_cast<char>(b));
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, va), _mm_cmpeq_epi8(x, vb)));
+        if (mask)
+            return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    return i + find2_scalar(p + i, length - i, a, b);
+}
+
+__attribute__((target("avx2")))
+inline std::size_t find2_avx2(const unsigned char *p, std::size_t length, unsigned char a, unsigned char b)
+{
+    const __m256i va = _mm256_set1_epi8(static_cast<char>(a));
+    const __m256i vb = _mm256_set1_epi8(static_cast<char>(b));
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        const unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(x, va), _mm256_cmpeq_epi8(x, vb))));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + find2_sse2(p + i, length - i, a, b);
+}
+
+#endif /* RDW_NTRIPLES_X86 */
+
+typedef std::size_t (*ScanFunction)(const unsigned char *, std::size_t, bool);
+typedef std::size_t (*Find2Function)(const unsigned char *, std::size_t, unsigned char, unsigned char);
+
+inline bool has_avx2()
+{
+#ifdef RDW_NTRIPLES_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+inline ScanFunction select_scan_function()
+{
+#ifdef RDW_NTRIPLES_X86
+    return has_avx2() ? &scan_avx2 : &scan_sse2;
+#else
+    return &scan_scalar;
+#endif
+}
+
+inline Find2Function select_find2_function()
+{
+#ifdef RDW_NTRIPLES_X86
+    return has_avx2() ? &find2_avx2 : &find2_sse2;
+#else
+    return &find2_scalar;
+#endif
+}
+
+/**
+ * Runtime dispatched scan, the implementation is selected on first use.
+ */
+inline std::size_t scan(const unsigned char *p, std::size_t length, bool iri)
+{
+    static const ScanFunction scan_function = select_scan_function();
+    return scan_function(p, length, iri);
+}
+
+/**
+ * Runtime dispatched search for either of two bytes.
+ */
+inline std::size_t find2(const unsigned char *p, std::size_t length, unsigned char a, unsigned char b)
+{
+    static const Find2Function find2_function = select_find2_function();
+    return find2_function(p, length, a, b);
+}
+
+} // namespace NTriplesDetail
+
+} // namespace Redland
+
+#endif /* RDW_NTRIPLES_SIMD_HPP_INCLUDED */
@@ -0,0 +1,288 @@
+/*
+ * ntriples_writer.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_NTRIPLES_WRITER_HPP_INCLUDED
+#define RDW_NTRIPLES_WRITER_HPP_INCLUDED
+
+#include "redland.hpp"
+#include "ntriples_simd.hpp"
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Native N-Triples / N-Quads writer.
+ *
+ * Terms are escaped by scanning for bytes that need an escape with
+ * SSE2/AVX2 (selected at runtime, scalar fallback on other CPUs) and
+ * copying the clean runs into a large output buffer. Output is UTF-8
+ * as specified by RDF 1.1 N-Triples, non-ASCII characters are not
+ * \u-escaped.
+ */
+class NTriplesWriter
+{
+public:
+
+    explicit NTriplesWriter(FILE *handle, std::size_t buffer_size = 1024 * 1024)
+        : handle_(handle)
+        , stream_(0)
+        , string_(0)
+        , buffer_(buffer_size ? buffer_size : 4096)
+        , pos_(0)
+        , ok_(true)
+    { }
+
+    explicit NTriplesWriter(std::ostream &out, std::size_t buffer_size = 1024 * 1024)
+        : handle_(0)
+        , stream_(&out)
+        , string_(0)
+        , buffer_(buffer_size ? buffer_size : 4096)
+        , pos_(0)
+        , ok_(true)
+    { }
+
+    explicit NTriplesWriter(std::string &dest, std::size_t buffer_size = 1024 * 1024)
+        : handle_(0)
+        , stream_(0)
+        , string_(&dest)
+        , buffer_(buffer_size ? buffer_size : 4096)
+        , pos_(0)
+        , ok_(true)
+    { }
+
+    NTriplesWriter(const NTriplesWriter &) = delete;
+    NTriplesWriter & operator=(const NTriplesWriter &) = delete;
+
+    ~NTriplesWriter()
+    {
+        flush();
+    }
+
+    bool flush()
+    {
+        if (pos_)
+            emit(buffer_.data(), pos_);
+        pos_ = 0;
+        if (handle_)
+            ok_ = fflush(handle_) == 0 && ok_;
+        else if (stream_)
+            ok_ = stream_->flush().good() && ok_;
+        return ok_;
+    }
+
+    /** False after any write error of the underlying output */
+    bool good() const { return ok_; }
+
+    void write_node(librdf_node *node)
+    {
+        size_t length = 0;
+        switch (librdf_node_get_type(node))
+        {
+            case LIBRDF_NODE_TYPE_RESOURCE:
+            {
+                const unsigned char *s = librdf_uri_as_counted_string(librdf_node_get_uri(node), &length);
+                write_iri(s, length);
+                break;
+            }
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                const unsigned char *s = librdf_node_get_literal_value_as_counted_string(node, &length);
+                put('"');
+                write_escaped(s, length, false);
+                put('"');
+                if (const char *language = librdf_node_get_literal_value_language(node))
+                {
+                    put('@');
+                    append(language, std::strlen(language));
+                }
+                else if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                {
+                    append("^^", 2);
+                    s = librdf_uri_as_counted_string(datatype, &length);
+                    write_iri(s, length);
+                }
+                break;
+            }
+            case LIBRDF_NODE_TYPE_BLANK:
+            {
+                const unsigned char *s = librdf_node_get_counted_blank_identifier(node, &length);
+                append("_:", 2);
+                append(reinterpret_cast<const char *>(s), length);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    /**
+     * Write one statement, as quad when context is not null.
+     */
+    void write_statement(librdf_statement *statement, librdf_node *context = 0)
+    {
+        write_node(librdf_statement_get_subject(statement));
+        put(' ');
+        write_node(librdf_statement_get_predicate(statement));
+        put(' ');
+        write_node(librdf_statement_get_object(statement));
+        if (context)
+        {
+            put(' ');
+            write_node(context);
+        }
+        append(" .\n", 3);
+    }
+
+    void write_statement(const Statement &statement)
+    {
+        write_statement(statement.c_obj());
+    }
+
+    /**
+     * Write all remaining statements of the stream, returns their number.
+     * With nquads set, stream contexts are written as graph names.
+     */
+    std::size_t write(Stream &stream, bool nquads = false)
+    {
+        std::size_t count = 0;
+        for (; stream.is_valid() && !stream.is_end(); stream.next())
+        {
+            if (librdf_statement *statement = librdf_stream_get_object(stream.c_obj()))
+            {
+                write_statement(statement, nquads ? librdf_stream_get_context2(stream.c_obj()) : 0);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    std::size_t write(const Model &model, bool nquads = false)
+    {
+        Stream stream(model.as_stream());
+        return write(stream, nquads);
+    }
+
+protected:
+
+    void emit(const char *data, std::size_t length)
+    {
+        if (handle_)
+            ok_ = fwrite(data, 1, length, handle_) == length && ok_;
+        else if (stream_)
+            ok_ = stream_->write(data, length).good() && ok_;
+        else if (string_)
+            string_->append(data, length);
+    }
+
+    void put(char c)
+    {
+        if (pos_ == buffer_.size())
+        {
+            emit(buffer_.data(), pos_);
+            pos_ = 0;
+        }
+        buffer_[pos_++] = c;
+    }
+
+    void append(const char *data, std::size_t length)
+    {
+        if (pos_ + length > buffer_.size())
+        {
+            emit(buffer_.data(), pos_);
+            pos_ = 0;
+            if (length > buffer_.size())
+            {
+                emit(data, length);
+                return;
+            }
+        }
+        std::memcpy(buffer_.data() + pos_, data, length);
+        pos_ += length;
+    }
+
+    void write_iri(const unsigned char *s, std::size_t length)
+    {
+        put('<');
+        write_escaped(s, length, true);
+        put('>');
+    }
+
+    void write_escaped(const unsigned char *s, std::size_t length, bool iri)
+    {
+        while (length)
+        {
+            const std::size_t clean = NTriplesDetail::scan(s, length, iri);
+            append(reinterpret_cast<const char *>(s), clean);
+            if (clean == length)
+                break;
+            write_escape(s[clean], iri);
+            s += clean + 1;
+            length -= clean + 1;
+        }
+    }
+
+    void write_escape(unsigned char c, bool iri)
+    {
+        if (!iri)
+        {
+            switch (c)
+            {
+                case '"':  append("\\\"", 2); return;
+                case '\\': append("\\\\", 2); return;
+                case '\n': append("\\n", 2); return;
+                case '\r': append("\\r", 2); return;
+                case '\t': append("\\t", 2); return;
+                default: break;
+            }
+        }
+        static const char hex[] = "0123456789ABCDEF";
+        const char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+        append(escape, 6);
+    }
+
+private:
+
+    FILE *handle_;
+    std::ostream *stream_;
+    std::string *string_;
+    std::vector<char> buffer_;
+    std::size_t pos_;
+    bool ok_;
+};
+
+inline bool write_ntriples(FILE *fd, const Model &model)
+{
+    NTriplesWriter writer(fd);
+    writer.write(model);
+    return writer.flush();
+}
+
+inline bool write_ntriples(const char *filename, const Model &model)
+{
+    FILE *fd = fopen(filename, "wb");
+    if (!fd)
+        return false;
+    bool result = write_ntriples(fd, model);
+    fclose(fd);
+    return result;
+}
+
+inline bool write_nquads(FILE *fd, const Model &model)
+{
+    NTriplesWriter writer(fd);
+    writer.write(model, true);
+    return writer.flush();
+}
+
+} // namespace Redland
+
+#endif /* RDW_NTRIPLES_WRITER_HPP_INCLUDED */
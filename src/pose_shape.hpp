@@ -0,0 +1,89 @@
+/*
+ * pose_shape.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef POSE_SHAPE_HPP_INCLUDED
+#define POSE_SHAPE_HPP_INCLUDED
+
+#include "rdf_shape.hpp"
+
+/**
+ * Pose written by the test writers: a spatial relationship with source and
+ * target coordinate systems, a translation vector and a rotation quaternion.
+ */
+namespace PoseShape
+{
+
+RDF_SHAPE_IRI(rdf_type, "http://www.w3.org/1999/02/22-rdf-syntax-ns#type");
+RDF_SHAPE_IRI(spatial_relationship, "http://vocab.arvida.de/2014/03/spatial/vocab#SpatialRelationship");
+RDF_SHAPE_IRI(source_coordinate_system, "http://vocab.arvida.de/2014/03/spatial/vocab#sourceCoordinateSystem");
+RDF_SHAPE_IRI(target_coordinate_system, "http://vocab.arvida.de/2014/03/spatial/vocab#targetCoordinateSystem");
+RDF_SHAPE_IRI(translation, "http://vocab.arvida.de/2014/03/spatial/vocab#translation");
+RDF_SHAPE_IRI(translation_3d, "http://vocab.arvida.de/2014/03/spatial/vocab#Translation3D");
+RDF_SHAPE_IRI(rotation, "http://vocab.arvida.de/2014/03/spatial/vocab#rotation");
+RDF_SHAPE_IRI(rotation_3d, "http://vocab.arvida.de/2014/03/spatial/vocab#Rotation3D");
+RDF_SHAPE_IRI(quantity_value, "http://vocab.arvida.de/2014/03/vom/vocab#quantityValue");
+RDF_SHAPE_IRI(left_handed_3d, "http://vocab.arvida.de/2014/03/maths/vocab#LeftHandedCartesianCoordinateSystem3D");
+RDF_SHAPE_IRI(right_handed_2d, "http://vocab.arvida.de/2014/03/maths/vocab#RightHandedCartesianCoordinateSystem2D");
+RDF_SHAPE_IRI(vector_3d, "http://vocab.arvida.de/2014/03/maths/vocab#Vector3D");
+RDF_SHAPE_IRI(vector_4d, "http://vocab.arvida.de/2014/03/maths/vocab#Vector4D");
+RDF_SHAPE_IRI(quaternion, "http://vocab.arvida.de/2014/03/maths/vocab#Quaternion");
+RDF_SHAPE_IRI(maths_x, "http://vocab.arvida.de/2014/03/maths/vocab#x");
+RDF_SHAPE_IRI(maths_y, "http://vocab.arvida.de/2014/03/maths/vocab#y");
+RDF_SHAPE_IRI(maths_z, "http://vocab.arvida.de/2014/03/maths/vocab#z");
+RDF_SHAPE_IRI(maths_w, "http://vocab.arvida.de/2014/03/maths/vocab#w");
+
+/** Indices into the values of Pose */
+enum Values
+{
+    TRANSLATION_X,
+    TRANSLATION_Y,
+    TRANSLATION_Z,
+    ROTATION_X,
+    ROTATION_Y,
+    ROTATION_Z,
+    ROTATION_W,
+    NUM_VALUES
+};
+
+using RDFShape::Triple;
+using RDFShape::Id;
+using RDFShape::Blank;
+using RDFShape::Value;
+
+typedef RDFShape::Shape<
+    Triple<Id<0>, rdf_type, spatial_relationship>,
+
+    Triple<Id<0>, source_coordinate_system, Blank<0> >,
+    Triple<Blank<0>, rdf_type, left_handed_3d>,
+
+    Triple<Id<0>, target_coordinate_system, Blank<1> >,
+    Triple<Blank<1>, rdf_type, right_handed_2d>,
+
+    Triple<Id<0>, translation, Blank<2> >,
+    Triple<Blank<2>, rdf_type, translation_3d>,
+    Triple<Blank<2>, quantity_value, Blank<3> >,
+    Triple<Blank<3>, rdf_type, vector_3d>,
+    Triple<Blank<3>, maths_x, Value<TRANSLATION_X> >,
+    Triple<Blank<3>, maths_y, Value<TRANSLATION_Y> >,
+    Triple<Blank<3>, maths_z, Value<TRANSLATION_Z> >,
+
+    Triple<Id<0>, rotation, Blank<4> >,
+    Triple<Blank<4>, rdf_type, rotation_3d>,
+    Triple<Blank<4>, quantity_value, Blank<5> >,
+    Triple<Blank<5>, rdf_type, quaternion>,
+    Triple<Blank<5>, rdf_type, vector_4d>,
+    Triple<Blank<5>, maths_x, Value<ROTATION_X> >,
+    Triple<Blank<5>, maths_y, Value<ROTATION_Y> >,
+    Triple<Blank<5>, maths_z, Value<ROTATION_Z> >,
+    Triple<Blank<5>, maths_w, Value<ROTATION_W> >
+> Pose;
+
+static_assert(int(Pose::num_values) == int(NUM_VALUES), "pose values out of sync");
+
+} // namespace PoseShape
+
+#endif /* POSE_SHAPE_HPP_INCLUDED */
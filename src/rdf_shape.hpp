@@ -0,0 +1,307 @@
+/*
+ * rdf_shape.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDF_SHAPE_HPP_INCLUDED
+#define RDF_SHAPE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+/**
+ * Compile time description of a fixed group of triples, for example a pose.
+ *
+ * A shape is a list of Triple<S, P, O> types. A term is either a constant
+ * IRI declared with RDF_SHAPE_IRI, or a slot which is filled for every
+ * emission: Id<I> for an IRI, Blank<I> for a fresh blank node and Value<I>
+ * for a numeric literal. An Emitter creates the constant nodes once and
+ * expands the triple list at compile time into a sequence of backend add
+ * calls with fixed node slots, so emitting a shape only creates the nodes
+ * of the slots.
+ */
+namespace RDFShape
+{
+
+/** Declare a constant IRI term, e.g. RDF_SHAPE_IRI(rdf_type, RDF("type")) */
+#define RDF_SHAPE_IRI(name, iri_string) \
+    struct name { static const char * iri() { return iri_string; } }
+
+template <unsigned I> struct Id { };
+
+template <unsigned I> struct Blank { };
+
+template <unsigned I> struct Value { };
+
+template <class S, class P, class O> struct Triple { };
+
+namespace Detail
+{
+
+enum TermKind { CONSTANT, ID, BLANK, VALUE };
+
+template <class T> struct Term { enum { kind = CONSTANT, index = 0 }; };
+template <unsigned I> struct Term<Id<I> > { enum { kind = ID, index = I }; };
+template <unsigned I> struct Term<Blank<I> > { enum { kind = BLANK, index = I }; };
+template <unsigned I> struct Term<Value<I> > { enum { kind = VALUE, index = I }; };
+
+template <class... Ts> struct List { };
+
+template <std::size_t... Is> struct Indices { };
+
+template <std::size_t N, std::size_t... Is>
+struct MakeIndices : MakeIndices<N - 1, N - 1, Is...> { };
+
+template <std::size_t... Is>
+struct MakeIndices<0, Is...> { typedef Indices<Is...> type; };
+
+/** Position of the first occurrence of T in the list */
+template <class T, class L> struct IndexOf;
+
+template <class T, class... Ts>
+struct IndexOf<T, List<T, Ts...> > { enum { value = 0 }; };
+
+template <class T, class U, class... Ts>
+struct IndexOf<T, List<U, Ts...> > { enum { value = 1 + IndexOf<T, List<Ts...> >::value }; };
+
+/** Number of slots of kind used by the terms, i.e. largest index + 1 */
+template <int Kind, class... Ts> struct NumSlots { enum { value = 0 }; };
+
+template <int Kind, class T, class... Ts>
+struct NumSlots<Kind, T, Ts...>
+{
+    enum
+    {
+        own = int(Term<T>::kind) == Kind ? int(Term<T>::index) + 1 : 0,
+        rest = NumSlots<Kind, Ts...>::value,
+        value = own > rest ? own : rest
+    };
+};
+
+template <class... Ts> struct AllConstant { enum { value = 1 }; };
+
+template <class T, class... Ts>
+struct AllConstant<T, Ts...>
+{
+    enum { value = int(Term<T>::kind) == CONSTANT && AllConstant<Ts...>::value };
+};
+
+template <bool B> struct Bool { };
+
+} // namespace Detail
+
+template <class... Triples> struct Shape;
+
+template <class... S, class... P, class... O>
+struct Shape<Triple<S, P, O>...>
+{
+    typedef Detail::List<Triple<S, P, O>...> Triples;
+    typedef Detail::List<S..., P..., O...> Terms;
+
+    enum
+    {
+        num_triples = sizeof...(S),
+        num_terms = 3 * sizeof...(S),
+        num_ids = Detail::NumSlots<Detail::ID, S..., O...>::value,
+        num_blanks = Detail::NumSlots<Detail::BLANK, S..., O...>::value,
+        num_values = Detail::NumSlots<Detail::VALUE, O...>::value
+    };
+
+    static_assert(Detail::AllConstant<P...>::value, "predicates of a shape must be constant IRIs");
+    static_assert(Detail::NumSlots<Detail::VALUE, S...>::value == 0, "literal values can only be objects");
+};
+
+/**
+ * Emits a Shape into a model through Backend, which provides
+ *
+ *   typedef ... node_type;   // raw node pointer, owned by the caller
+ *   node_type make_uri(const char *uri, std::size_t length);
+ *   node_type make_blank();
+ *   node_type make_double(double value);
+ *   void free(node_type node);
+ *   bool add(node_type subject, node_type predicate, node_type object);
+ *
+ * The make functions throw when they can not create a node, they never
+ * return a null node. Value slots keep their node between emissions and
+ * only create a new literal when the value changed.
+ */
+template <class ShapeT, class Backend>
+class Emitter
+{
+public:
+    typedef ShapeT shape_type;
+    typedef typename Backend::node_type node_type;
+
+    enum
+    {
+        num_triples = ShapeT::num_triples,
+        num_ids = ShapeT::num_ids,
+        num_blanks = ShapeT::num_blanks,
+        num_values = ShapeT::num_values
+    };
+
+    /** Arguments are forwarded to the Backend constructor */
+    template <class... Args>
+    explicit Emitter(Args &&... args)
+        : backend_(std::forward<Args>(args)...)
+    {
+        std::memset(constants_, 0, sizeof(constants_));
+        std::memset(ids_, 0, sizeof(ids_));
+        std::memset(blanks_, 0, sizeof(blanks_));
+        std::memset(values_, 0, sizeof(values_));
+        std::memset(value_bits_, 0, sizeof(value_bits_));
+        try
+        {
+            bind(typename ShapeT::Terms(), typename Detail::MakeIndices<ShapeT::num_terms>::type());
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    Emitter(const Emitter &) = delete;
+    Emitter & operator=(const Emitter &) = delete;
+
+    ~Emitter()
+    {
+        release();
+    }
+
+    Backend & backend() { return backend_; }
+
+    /**
+     * Add one instance of the shape. ids holds num_ids IRIs and values
+     * num_values numbers. Returns false if the backend did not add a
+     * statement.
+     */
+    bool emit(const std::string *ids, const double *values)
+    {
+        SlotGuard guard(*this);
+        for (; guard.num_ids < std::size_t(num_ids); ++guard.num_ids)
+            ids_[guard.num_ids] = backend_.make_uri(ids[guard.num_ids].data(), ids[guard.num_ids].size());
+        for (; guard.num_blanks < std::size_t(num_blanks); ++guard.num_blanks)
+            blanks_[guard.num_blanks] = backend_.make_blank();
+        for (std::size_t i = 0; i < std::size_t(num_values); ++i)
+            set_value(i, values[i]);
+        return add(typename ShapeT::Triples());
+    }
+
+    bool emit(const std::string &id, const double *values)
+    {
+        static_assert(num_ids == 1, "shape has more than one id");
+        return emit(&id, values);
+    }
+
+private:
+
+    struct SlotGuard
+    {
+        Emitter &emitter;
+        std::size_t num_ids;
+        std::size_t num_blanks;
+
+        explicit SlotGuard(Emitter &emitter) : emitter(emitter), num_ids(0), num_blanks(0) { }
+
+        ~SlotGuard()
+        {
+            for (std::size_t i = 0; i < num_ids; ++i)
+                emitter.backend_.free(emitter.ids_[i]);
+            for (std::size_t i = 0; i < num_blanks; ++i)
+                emitter.backend_.free(emitter.blanks_[i]);
+        }
+    };
+
+    void set_value(std::size_t i, double value)
+    {
+        // compare bits, so that -0.0 and NaN are handled like other values
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if (values_[i] && value_bits_[i] == bits)
+            return;
+        node_type node = backend_.make_double(value);
+        if (values_[i])
+            backend_.free(values_[i]);
+        values_[i] = node;
+        value_bits_[i] = bits;
+    }
+
+    template <class... Ts, std::size_t... Is>
+    void bind(Detail::List<Ts...>, Detail::Indices<Is...>)
+    {
+        int expand[] = { 0, (bind_term<Ts, Is>(), 0)... };
+        (void)expand;
+    }
+
+    template <class T, std::size_t I>
+    void bind_term()
+    {
+        bind_term<T, I>(Detail::Bool<int(Detail::Term<T>::kind) == Detail::CONSTANT &&
+                                     std::size_t(Detail::IndexOf<T, typename ShapeT::Terms>::value) == I>());
+    }
+
+    template <class T, std::size_t I>
+    void bind_term(Detail::Bool<true>)
+    {
+        const char *iri = T::iri();
+        constants_[I] = backend_.make_uri(iri, std::strlen(iri));
+    }
+
+    template <class T, std::size_t I>
+    void bind_term(Detail::Bool<false>) { }
+
+    template <class T>
+    node_type term(T *) const { return constants_[Detail::IndexOf<T, typename ShapeT::Terms>::value]; }
+
+    template <unsigned I>
+    node_type term(Id<I> *) const { return ids_[I]; }
+
+    template <unsigned I>
+    node_type term(Blank<I> *) const { return blanks_[I]; }
+
+    template <unsigned I>
+    node_type term(Value<I> *) const { return values_[I]; }
+
+    template <class... S, class... P, class... O>
+    bool add(Detail::List<Triple<S, P, O>...>)
+    {
+        bool ok = true;
+        int expand[] = { 0, ((ok = backend_.add(term((S *)0), term((P *)0), term((O *)0)) && ok), 0)... };
+        (void)expand;
+        return ok;
+    }
+
+    void release()
+    {
+        for (std::size_t i = 0; i < std::size_t(ShapeT::num_terms); ++i)
+        {
+            if (constants_[i])
+                backend_.free(constants_[i]);
+            constants_[i] = 0;
+        }
+        for (std::size_t i = 0; i < std::size_t(num_values); ++i)
+        {
+            if (values_[i])
+                backend_.free(values_[i]);
+            values_[i] = 0;
+        }
+    }
+
+    Backend backend_;
+    // constants are stored at the position of their first occurrence
+    node_type constants_[ShapeT::num_terms];
+    node_type ids_[num_ids > 0 ? num_ids : 1];
+    node_type blanks_[num_blanks > 0 ? num_blanks : 1];
+    node_type values_[num_values > 0 ? num_values : 1];
+    uint64_t value_bits_[num_values > 0 ? num_values : 1];
+};
+
+} // namespace RDFShape
+
+#endif /* RDF_SHAPE_HPP_INCLUDED */
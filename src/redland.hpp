@@ -9,16 +9,28 @@
 #define RDW_HPP_INCLUDED
 
 #include <redland.h>
+#include "blank_tag.hpp"
 #include <utility>
 #include <exception>
 #include <string>
 #include <sstream>
+#include <list>
 #include <map>
+#include <memory>
 #include <vector>
 #include <unordered_set>
 #include <istream>
 #include <ostream>
 #include <iterator>
+#include <functional>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <boost/utility/string_ref.hpp>
 
 // Macros from Boost C++ Libraries
 
@@ -45,6 +57,9 @@
 namespace Redland
 {
 
+/** Non-owning view of a character range, std::string_view is C++17 */
+typedef boost::string_ref StringRef;
+
 class Exception : public std::exception
 {
 public:
@@ -110,6 +125,14 @@ protected:
 
 };
 
+struct defer_open_t { };
+
+class Namespaces;
+class NodeView;
+class Parser;
+class Serializer;
+struct FormatCache;
+
 class World : public CObjWrapper<librdf_world>
 {
 public:
@@ -122,47 +145,337 @@ public:
         librdf_world_open(c_obj_);
     }
 
+    /**
+     * Create world without opening it. Factories are initialized by open()
+     * or by the first librdf constructor that needs them, so a world that
+     * is created ahead of time but never used costs little.
+     */
+    explicit World(defer_open_t)
+        : CObjWrapper(librdf_new_world())
+    {
+        if (!c_obj_)
+            throw AllocException("librdf_new_world");
+    }
+
     World(const World &) = delete;
 
     World(World && other)
         : CObjWrapper(std::move(other))
+        , format_cache_(std::move(other.format_cache_))
     {
     }
 
-    World & operator=(World && other)
+    World & operator=(World && other);
+
+    World & operator=(const World & other) = delete;
+
+    ~World();
+
+    void open()
     {
-        return static_cast<World&>(CObjWrapper::operator=(std::move(other)));
+        librdf_world_open(c_obj_);
     }
 
-    World & operator=(const World & other) = delete;
+    /**
+     * Parser for format_name kept in this world for reuse, null when the
+     * format is not supported. The cache keeps the most recently used
+     * parsers, a parser evicted or cleared from it stays valid as long as
+     * it is held, but not longer than the world.
+     */
+    std::shared_ptr<Parser> cached_parser(const char *format_name) const;
 
-    ~World()
+    /**
+     * Serializer for format_name with namespaces already registered, kept
+     * in this world for reuse like cached_parser. Null when the format is
+     * not supported.
+     */
+    std::shared_ptr<Serializer> cached_serializer(const char *format_name, const Namespaces &namespaces) const;
+
+    void clear_format_cache() const;
+
+private:
+    mutable std::unique_ptr<FormatCache> format_cache_;
+
+};
+
+/**
+ * Compressed byte trie mapping strings to indices. for_each_prefix visits
+ * all stored keys that are a prefix of a string in one pass, lookups do
+ * not allocate.
+ */
+class PrefixTrie
+{
+public:
+
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    PrefixTrie()
+        : nodes_(1)
+    { }
+
+    void clear()
+    {
+        nodes_.assign(1, TrieNode());
+    }
+
+    void insert(StringRef key, std::size_t value)
+    {
+        std::size_t node = 0;
+        std::size_t pos = 0;
+        for (;;)
+        {
+            if (pos == key.size())
+            {
+                nodes_[node].value = value;
+                return;
+            }
+            const std::size_t slot = child_slot(node, key[pos]);
+            if (slot == nodes_[node].children.size() || nodes_[node].children[slot].first != key[pos])
+            {
+                TrieNode leaf;
+                leaf.label.assign(key.data() + pos, key.size() - pos);
+                leaf.value = value;
+                nodes_.push_back(leaf);
+                nodes_[node].children.insert(nodes_[node].children.begin() + slot,
+                                             std::make_pair(key[pos], static_cast<uint32_t>(nodes_.size() - 1)));
+                return;
+            }
+
+            const std::size_t child = nodes_[node].children[slot].second;
+            const std::string &label = nodes_[child].label;
+            std::size_t common = 0;
+            while (common < label.size() && pos + common < key.size() && label[common] == key[pos + common])
+                ++common;
+
+            if (common < label.size())
+            {
+                // split the edge, the new middle node takes over the slot
+                TrieNode middle;
+                middle.label.assign(label, 0, common);
+                middle.children.push_back(std::make_pair(label[common], static_cast<uint32_t>(child)));
+                nodes_[child].label.erase(0, common);
+                nodes_.push_back(middle);
+                nodes_[node].children[slot].second = static_cast<uint32_t>(nodes_.size() - 1);
+                node = nodes_.size() - 1;
+            }
+            else
+            {
+                node = child;
+            }
+            pos += common;
+        }
+    }
+
+    /** Remove the value of key, the nodes are kept */
+    void erase(StringRef key)
+    {
+        std::size_t node = 0;
+        std::size_t pos = 0;
+        while (pos < key.size())
+        {
+            const std::size_t slot = child_slot(node, key[pos]);
+            if (slot == nodes_[node].children.size() || nodes_[node].children[slot].first != key[pos])
+                return;
+            node = nodes_[node].children[slot].second;
+            const std::string &label = nodes_[node].label;
+            if (key.size() - pos < label.size() || std::memcmp(label.data(), key.data() + pos, label.size()) != 0)
+                return;
+            pos += label.size();
+        }
+        nodes_[node].value = npos;
+    }
+
+    /** Value of key, or npos */
+    std::size_t find(StringRef key) const
+    {
+        std::size_t value = npos;
+        for_each_prefix(key, [&](std::size_t length, std::size_t v)
+            {
+                if (length == key.size())
+                    value = v;
+            });
+        return value;
+    }
+
+    /**
+     * Call function(length, value) for every stored key that is a prefix
+     * of s, shortest first.
+     */
+    template <class Function>
+    void for_each_prefix(StringRef s, Function function) const
+    {
+        std::size_t node = 0;
+        std::size_t pos = 0;
+        for (;;)
+        {
+            if (nodes_[node].value != npos)
+                function(pos, nodes_[node].value);
+            if (pos == s.size())
+                return;
+            const std::size_t slot = child_slot(node, s[pos]);
+            if (slot == nodes_[node].children.size() || nodes_[node].children[slot].first != s[pos])
+                return;
+            node = nodes_[node].children[slot].second;
+            const std::string &label = nodes_[node].label;
+            if (s.size() - pos < label.size() || std::memcmp(label.data(), s.data() + pos, label.size()) != 0)
+                return;
+            pos += label.size();
+        }
+    }
+
+private:
+
+    struct TrieNode
+    {
+        std::string label;
+        std::vector<std::pair<char, uint32_t> > children;
+        std::size_t value;
+
+        TrieNode() : value(npos) { }
+    };
+
+    /** Position of the child starting with c, or where it would be inserted */
+    std::size_t child_slot(std::size_t node, char c) const
     {
-        librdf_free_world(c_obj_);
+        const std::vector<std::pair<char, uint32_t> > &children = nodes_[node].children;
+        std::size_t slot = 0;
+        while (slot < children.size() && children[slot].first < c)
+            ++slot;
+        return slot;
     }
 
+    std::vector<TrieNode> nodes_;
 };
 
+/**
+ * Prefix names and namespace URIs. Prefixes are indexed in the order they
+ * were added and keep their index when their URI is changed. When several
+ * prefixes share a URI, compact uses the first one added.
+ */
 class Namespaces
 {
 public:
+
+    static const std::size_t npos = PrefixTrie::npos;
+
     Namespaces() { }
 
     void add_prefix(const std::string& prefix, const std::string& uri)
     {
         prefixToUriMap_[prefix] = uri;
+        const std::size_t index = names_.find(prefix);
+        if (index == npos)
+        {
+            entries_.push_back(std::make_pair(prefix, uri));
+            names_.insert(prefix, entries_.size() - 1);
+            if (uris_.find(uri) == npos)
+                uris_.insert(uri, entries_.size() - 1);
+            return;
+        }
+        if (entries_[index].second == uri)
+            return;
+        const std::string previous = entries_[index].second;
+        entries_[index].second = uri;
+        if (uris_.find(previous) == index)
+            replace_uri(previous);
+        if (uris_.find(uri) == npos)
+            uris_.insert(uri, index);
     }
 
-    std::string expand(const std::string uri) const
+    const std::map<std::string, std::string> & prefix_map() const
     {
-        std::string::size_type i = uri.find(":");
-        if (i == std::string::npos)
-            return uri;
-        std::string prefix = uri.substr(0, i);
-        std::map<std::string, std::string>::const_iterator it = prefixToUriMap_.find(prefix);
-        if (it == prefixToUriMap_.end())
+        return prefixToUriMap_;
+    }
+
+    std::size_t num_prefixes() const { return entries_.size(); }
+
+    StringRef prefix_name(std::size_t index) const { return entries_[index].first; }
+
+    StringRef prefix_uri(std::size_t index) const { return entries_[index].second; }
+
+    std::string expand(const std::string &uri) const
+    {
+        std::string result;
+        if (!expand(StringRef(uri), result))
             return uri;
-        return it->second + uri.substr(i+1);
+        return result;
+    }
+
+    /**
+     * Expand CURIE prefix:local into out, false when the prefix is unknown.
+     * Only out may allocate.
+     */
+    bool expand(StringRef curie, std::string &out) const
+    {
+        const StringRef::size_type i = curie.find(':');
+        if (i == StringRef::npos)
+            return false;
+        const std::size_t index = names_.find(curie.substr(0, i));
+        if (index == npos)
+            return false;
+        const std::string &uri = entries_[index].second;
+        out.assign(uri);
+        out.append(curie.data() + i + 1, curie.size() - i - 1);
+        return true;
+    }
+
+    /**
+     * Index of the longest namespace that is a prefix of iri and leaves a
+     * valid local name, or npos. local_offset is set to the namespace length.
+     */
+    std::size_t find_compact(StringRef iri, std::size_t &local_offset) const
+    {
+        std::size_t best = npos;
+        uris_.for_each_prefix(iri, [&](std::size_t length, std::size_t index)
+            {
+                if (is_local_name(iri.data() + length, iri.size() - length))
+                {
+                    best = index;
+                    local_offset = length;
+                }
+            });
+        return best;
+    }
+
+    /** Split iri into prefix name and local name, both views, no allocation */
+    bool compact(StringRef iri, StringRef &prefix, StringRef &local) const
+    {
+        std::size_t offset = 0;
+        const std::size_t index = find_compact(iri, offset);
+        if (index == npos)
+            return false;
+        prefix = entries_[index].first;
+        local = iri.substr(offset);
+        return true;
+    }
+
+    /** Write prefix:local into out, false when no namespace fits */
+    bool compact(StringRef iri, std::string &out) const
+    {
+        StringRef prefix, local;
+        if (!compact(iri, prefix, local))
+            return false;
+        out.assign(prefix.data(), prefix.size());
+        out += ':';
+        out.append(local.data(), local.size());
+        return true;
+    }
+
+    /**
+     * Conservative check for a Turtle local name: letters, digits, '_' and
+     * '-' except at the start.
+     */
+    static bool is_local_name(const char *s, std::size_t length)
+    {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            const char c = s[i];
+            const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                || c == '_' || (c == '-' && i != 0);
+            if (!valid)
+                return false;
+        }
+        return true;
     }
 
     void register_with_serializer(const World &world, librdf_serializer *ser) const
@@ -178,7 +491,25 @@ public:
     }
 
 private:
+
+    /** Map uri to the first prefix still using it, after its prefix changed */
+    void replace_uri(const std::string &uri)
+    {
+        for (std::size_t i = 0; i < entries_.size(); ++i)
+        {
+            if (entries_[i].second == uri)
+            {
+                uris_.insert(uri, i);
+                return;
+            }
+        }
+        uris_.erase(uri);
+    }
+
     std::map<std::string, std::string> prefixToUriMap_;
+    std::vector<std::pair<std::string, std::string> > entries_;
+    PrefixTrie names_;
+    PrefixTrie uris_;
 };
 
 class Uri : public CObjWrapper<librdf_uri>
@@ -429,11 +760,34 @@ public:
         librdf_free_node(c_obj_);
     }
 
+    /**
+     * Nodes are equal when they have the same type and content. Two invalid
+     * nodes compare equal.
+     */
     bool operator==(const Node &other) const
     {
-        return librdf_node_equals(c_obj(), other.c_obj()) == 0;
+        if (c_obj_ == other.c_obj_)
+            return true;
+        if (!c_obj_ || !other.c_obj_)
+            return false;
+        return librdf_node_equals(c_obj_, other.c_obj_) != 0;
+    }
+
+    bool operator!=(const Node &other) const
+    {
+        return !operator==(other);
     }
 
+    /**
+     * Hash of node content, consistent with operator==
+     */
+    std::size_t hash() const;
+
+    /**
+     * Non-owning view, for reading strings without copying them
+     */
+    NodeView view() const;
+
     bool is_blank() const { return librdf_node_is_blank(c_obj_); }
 
     bool is_literal() const { return librdf_node_is_literal(c_obj_); }
@@ -517,107 +871,520 @@ public:
         return Node(world, uri_string);
     }
 
+    /**
+     * Create node from raptor term as delivered by raptor statement handlers.
+     */
+    static Node make_from_raptor_term(const World &world, const raptor_term *term)
+    {
+        librdf_node *node = 0;
+        switch (term->type)
+        {
+            case RAPTOR_TERM_TYPE_URI:
+            {
+                size_t length = 0;
+                const unsigned char *s = raptor_uri_as_counted_string(term->value.uri, &length);
+                node = librdf_new_node_from_counted_uri_string(world.c_obj(), s, length);
+                break;
+            }
+            case RAPTOR_TERM_TYPE_LITERAL:
+            {
+                librdf_uri *datatype = 0;
+                if (term->value.literal.datatype)
+                {
+                    size_t length = 0;
+                    const unsigned char *s = raptor_uri_as_counted_string(term->value.literal.datatype, &length);
+                    datatype = librdf_new_uri2(world.c_obj(), s, length);
+                }
+                node = librdf_new_node_from_typed_counted_literal(world.c_obj(),
+                    term->value.literal.string, term->value.literal.string_len,
+                    reinterpret_cast<const char *>(term->value.literal.language), term->value.literal.language_len,
+                    datatype);
+                librdf_free_uri(datatype);
+                break;
+            }
+            case RAPTOR_TERM_TYPE_BLANK:
+                node = librdf_new_node_from_counted_blank_identifier(world.c_obj(),
+                    term->value.blank.string, term->value.blank.string_len);
+                break;
+            default:
+                return Node();
+        }
+        if (!node)
+            throw AllocException("librdf_new_node_from_raptor_term");
+        return Node(node);
+    }
+
 };
 
-struct shallow_copy_t { };
+/**
+ * Hash and equality of node content, computed on librdf's counted strings
+ * without converting nodes to std::string.
+ */
+struct NodeHash
+{
+    static std::size_t hash_bytes(std::size_t h, const unsigned char *s, std::size_t length)
+    {
+        // FNV-1a
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            h ^= s[i];
+            h *= static_cast<std::size_t>(1099511628211ULL);
+        }
+        return h;
+    }
 
-class Statement : public CObjWrapper<librdf_statement>
+    std::size_t operator()(librdf_node *node) const
+    {
+        std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+        if (!node)
+            return h;
+        const librdf_node_type type = librdf_node_get_type(node);
+        h = hash_bytes(h, reinterpret_cast<const unsigned char *>(&type), sizeof(type));
+        size_t length = 0;
+        switch (type)
+        {
+            case LIBRDF_NODE_TYPE_RESOURCE:
+            {
+                const unsigned char *s = librdf_uri_as_counted_string(librdf_node_get_uri(node), &length);
+                return hash_bytes(h, s, length);
+            }
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                const unsigned char *s = librdf_node_get_literal_value_as_counted_string(node, &length);
+                h = hash_bytes(h, s, length);
+                if (const char *language = librdf_node_get_literal_value_language(node))
+                    h = hash_bytes(h, reinterpret_cast<const unsigned char *>(language), std::strlen(language));
+                if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                {
+                    s = librdf_uri_as_counted_string(datatype, &length);
+                    h = hash_bytes(h, s, length);
+                }
+                return h;
+            }
+            case LIBRDF_NODE_TYPE_BLANK:
+            {
+                const unsigned char *s = librdf_node_get_counted_blank_identifier(node, &length);
+                return hash_bytes(h, s, length);
+            }
+            default:
+                return h;
+        }
+    }
+
+    std::size_t operator()(const Node &node) const
+    {
+        return operator()(node.c_obj());
+    }
+};
+
+struct NodeEqual
+{
+    bool operator()(librdf_node *a, librdf_node *b) const
+    {
+        if (a == b)
+            return true;
+        if (!a || !b)
+            return false;
+        return librdf_node_equals(a, b) != 0;
+    }
+
+    bool operator()(const Node &a, const Node &b) const
+    {
+        return a == b;
+    }
+};
+
+inline std::size_t Node::hash() const
+{
+    return NodeHash()(c_obj_);
+}
+
+typedef std::unordered_set<Node, NodeHash, NodeEqual> NodeSet;
+
+/**
+ * Non-owning view of a node. Accessors return references to the strings
+ * of the node, which stay valid as long as the node does. Strings are
+ * also NUL terminated, as librdf keeps them.
+ */
+class NodeView
 {
 public:
 
-    Statement()
-        : CObjWrapper(0)
+    NodeView()
+        : node_(0)
     { }
 
-    Statement(librdf_statement *statement)
-        : CObjWrapper(statement)
+    NodeView(librdf_node *node)
+        : node_(node)
     { }
 
-    Statement(const World &world)
-        : CObjWrapper(librdf_new_statement(world.c_obj()))
+    NodeView(const Node &node)
+        : node_(node.c_obj())
+    { }
+
+    librdf_node * c_obj() const { return node_; }
+
+    bool is_valid() const { return node_ != 0; }
+
+    bool is_resource() const { return node_ && librdf_node_is_resource(node_); }
+
+    bool is_blank() const { return node_ && librdf_node_is_blank(node_); }
+
+    bool is_literal() const { return node_ && librdf_node_is_literal(node_); }
+
+    /** URI of a resource node, empty for other nodes */
+    StringRef uri() const
     {
-        if (!c_obj_)
-            throw AllocException("librdf_new_statement");
+        return is_resource() ? uri_string(librdf_node_get_uri(node_)) : StringRef();
     }
 
-    Statement(const Statement &other)
-        : CObjWrapper(other.is_valid() ? librdf_new_statement_from_statement(other.c_obj()) : 0)
+    /** Value of a literal node, empty for other nodes */
+    StringRef literal_value() const
     {
-        if (other.is_valid() && !c_obj_)
-            throw AllocException("librdf_new_statement_from_statement");
+        if (!is_literal())
+            return StringRef();
+        size_t length = 0;
+        const unsigned char *s = librdf_node_get_literal_value_as_counted_string(node_, &length);
+        return StringRef(reinterpret_cast<const char *>(s), length);
     }
 
-    Statement(const Statement &other, shallow_copy_t)
-        : CObjWrapper(other.is_valid() ? librdf_new_statement_from_statement2(other.c_obj()) : 0)
+    /** Language of a literal node, empty when it has none */
+    StringRef language() const
     {
-        if (other.is_valid() && !c_obj_)
-            throw AllocException("librdf_new_statement_from_statement2");
+        const char *language = is_literal() ? librdf_node_get_literal_value_language(node_) : 0;
+        return language ? StringRef(language) : StringRef();
     }
 
-    Statement(Statement && other)
-        : CObjWrapper(std::move(other))
+    /** Datatype URI of a literal node, empty when it has none */
+    StringRef datatype() const
     {
+        librdf_uri *datatype = is_literal() ? librdf_node_get_literal_value_datatype_uri(node_) : 0;
+        return datatype ? uri_string(datatype) : StringRef();
     }
 
-    Statement & operator=(Statement && other)
+    /** Identifier of a blank node, empty for other nodes */
+    StringRef blank_identifier() const
     {
-        librdf_free_statement(c_obj_);
-        c_obj_ = 0;
-        return static_cast<Statement&>(CObjWrapper::operator=(std::move(other)));
+        if (!is_blank())
+            return StringRef();
+        size_t length = 0;
+        const unsigned char *s = librdf_node_get_counted_blank_identifier(node_, &length);
+        return StringRef(reinterpret_cast<const char *>(s), length);
     }
 
-    Statement & operator=(const Statement & other)
+    /** Same content as Node::to_string */
+    StringRef value() const
     {
-        if (this != &other)
-        {
-            librdf_free_statement(c_obj_);
-            c_obj_ = other.is_valid() ? librdf_new_statement_from_statement(other.c_obj()) : 0;
-        }
-        return *this;
+        return is_blank() ? blank_identifier() : (is_literal() ? literal_value() : uri());
     }
 
-    Statement(const World &world, Node subject, Node predicate, Node object)
-        : CObjWrapper(librdf_new_statement_from_nodes(world.c_obj(), subject.release(), predicate.release(), object.release()))
+    bool operator==(const NodeView &other) const
     {
-        if (!c_obj_)
-            throw AllocException("librdf_new_statement_from_nodes");
+        return NodeEqual()(node_, other.node_);
     }
 
-    ~Statement()
+    bool operator!=(const NodeView &other) const
     {
-        librdf_free_statement(c_obj_);
+        return !operator==(other);
     }
 
-    Node get_subject() const
+    std::size_t hash() const
     {
-        if (is_valid())
-        {
-            if (librdf_node *n = librdf_statement_get_subject(c_obj_))
-                return Node(librdf_new_node_from_node(n));
-        }
-        return Node();
+        return NodeHash()(node_);
     }
 
-    Node get_predicate() const
+    /** Owning copy of the viewed node */
+    Node to_node() const
     {
-        if (is_valid())
-        {
-            if (librdf_node *n = librdf_statement_get_predicate(c_obj_))
-                return Node(librdf_new_node_from_node(n));
-        }
-        return Node();
+        return Node(node_ ? librdf_new_node_from_node(node_) : 0);
     }
 
-    Node get_object() const
+private:
+
+    static StringRef uri_string(librdf_uri *uri)
     {
-        if (is_valid())
-        {
-            if (librdf_node *n = librdf_statement_get_object(c_obj_))
+        size_t length = 0;
+        const unsigned char *s = librdf_uri_as_counted_string(uri, &length);
+        return StringRef(reinterpret_cast<const char *>(s), length);
+    }
+
+    librdf_node *node_;
+};
+
+inline NodeView Node::view() const
+{
+    return NodeView(c_obj_);
+}
+
+/**
+ * Shared source of blank node numbers. Allocators take numbers in blocks,
+ * so the atomic counter is touched once per block, not once per node.
+ *
+ * Numbers restart at 0 for every source, so each source also has a tag
+ * which allocators put into the identifiers. The tag is random by default,
+ * which keeps identifiers of different runs and of different sources
+ * apart, e.g. when data written by an earlier run is loaded again. Use
+ * one source per world to keep worlds apart as well.
+ */
+class BlankNodeIdSource
+{
+public:
+
+    enum { tag_length = Arvida::RDF::BlankTag::length };
+
+    /** Source with a random tag */
+    BlankNodeIdSource()
+        : next_(0)
+    {
+        set_tag(random_seed());
+    }
+
+    /** Source with a tag derived from seed, for reproducible output */
+    explicit BlankNodeIdSource(uint64_t seed)
+        : next_(0)
+    {
+        set_tag(seed);
+    }
+
+    BlankNodeIdSource(const BlankNodeIdSource &) = delete;
+    BlankNodeIdSource & operator=(const BlankNodeIdSource &) = delete;
+
+    /** tag_length hex digits, not null terminated */
+    const char * tag() const { return tag_; }
+
+    /** First number of a new block of size numbers */
+    uint64_t take_block(uint64_t size)
+    {
+        return next_.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    /** Process wide source used by default */
+    static BlankNodeIdSource & global()
+    {
+        static BlankNodeIdSource source;
+        return source;
+    }
+
+private:
+
+    static uint64_t random_seed()
+    {
+        return Arvida::RDF::BlankTag::random_seed();
+    }
+
+    void set_tag(uint64_t seed)
+    {
+        Arvida::RDF::BlankTag::format(seed, tag_);
+    }
+
+    std::atomic<uint64_t> next_;
+    char tag_[tag_length];
+};
+
+/**
+ * Counter based blank node allocator.
+ *
+ * Node::make_blank_node lets librdf generate an identifier with the
+ * world's generator. The allocator instead formats prefix + source tag +
+ * hex counter into a stack buffer, with counters taken in blocks from a
+ * shared BlankNodeIdSource. Use one allocator per thread; allocators
+ * sharing a source never hand out the same identifier.
+ */
+class BlankNodeAllocator
+{
+public:
+
+    /** Longest prefix kept, longer prefixes are cut */
+    enum { max_prefix_length = 16 };
+
+    explicit BlankNodeAllocator(BlankNodeIdSource &source = BlankNodeIdSource::global(),
+                                const char *prefix = "rdwb",
+                                uint64_t block_size = 4096)
+        : source_(source)
+        , prefix_length_(std::min<std::size_t>(std::strlen(prefix), max_prefix_length))
+        , block_size_(block_size ? block_size : 1)
+        , next_(0)
+        , end_(0)
+    {
+        std::memcpy(prefix_, prefix, prefix_length_);
+        std::memcpy(prefix_ + prefix_length_, source.tag(), BlankNodeIdSource::tag_length);
+        prefix_length_ += BlankNodeIdSource::tag_length;
+    }
+
+    BlankNodeAllocator(const BlankNodeAllocator &) = delete;
+    BlankNodeAllocator & operator=(const BlankNodeAllocator &) = delete;
+
+    /** Next blank node number, for callers that keep integers */
+    uint64_t next_id()
+    {
+        if (next_ == end_)
+        {
+            next_ = source_.take_block(block_size_);
+            end_ = next_ + block_size_;
+        }
+        return next_++;
+    }
+
+    /**
+     * Write identifier of id to buffer, which must have room for
+     * max_identifier_length bytes. Returns the identifier length.
+     */
+    std::size_t format(uint64_t id, char *buffer) const
+    {
+        static const char hex[] = "0123456789abcdef";
+        std::memcpy(buffer, prefix_, prefix_length_);
+        char digits[16];
+        std::size_t n = 0;
+        do
+        {
+            digits[n++] = hex[id & 0xF];
+            id >>= 4;
+        } while (id);
+        for (std::size_t i = 0; i < n; ++i)
+            buffer[prefix_length_ + i] = digits[n - 1 - i];
+        return prefix_length_ + n;
+    }
+
+    static const std::size_t max_identifier_length = max_prefix_length + BlankNodeIdSource::tag_length + 16;
+
+    Node make_node(const World &world)
+    {
+        char buffer[max_identifier_length];
+        const std::size_t length = format(next_id(), buffer);
+        librdf_node *node = librdf_new_node_from_counted_blank_identifier(world.c_obj(),
+            reinterpret_cast<const unsigned char *>(buffer), length);
+        if (!node)
+            throw AllocException("librdf_new_node_from_counted_blank_identifier");
+        return Node(node);
+    }
+
+private:
+    BlankNodeIdSource &source_;
+    char prefix_[max_prefix_length + BlankNodeIdSource::tag_length];
+    std::size_t prefix_length_;
+    uint64_t block_size_;
+    uint64_t next_;
+    uint64_t end_;
+};
+
+struct shallow_copy_t { };
+
+class Statement : public CObjWrapper<librdf_statement>
+{
+public:
+
+    Statement()
+        : CObjWrapper(0)
+    { }
+
+    Statement(librdf_statement *statement)
+        : CObjWrapper(statement)
+    { }
+
+    Statement(const World &world)
+        : CObjWrapper(librdf_new_statement(world.c_obj()))
+    {
+        if (!c_obj_)
+            throw AllocException("librdf_new_statement");
+    }
+
+    Statement(const Statement &other)
+        : CObjWrapper(other.is_valid() ? librdf_new_statement_from_statement(other.c_obj()) : 0)
+    {
+        if (other.is_valid() && !c_obj_)
+            throw AllocException("librdf_new_statement_from_statement");
+    }
+
+    Statement(const Statement &other, shallow_copy_t)
+        : CObjWrapper(other.is_valid() ? librdf_new_statement_from_statement2(other.c_obj()) : 0)
+    {
+        if (other.is_valid() && !c_obj_)
+            throw AllocException("librdf_new_statement_from_statement2");
+    }
+
+    Statement(Statement && other)
+        : CObjWrapper(std::move(other))
+    {
+    }
+
+    Statement & operator=(Statement && other)
+    {
+        librdf_free_statement(c_obj_);
+        c_obj_ = 0;
+        return static_cast<Statement&>(CObjWrapper::operator=(std::move(other)));
+    }
+
+    Statement & operator=(const Statement & other)
+    {
+        if (this != &other)
+        {
+            librdf_free_statement(c_obj_);
+            c_obj_ = other.is_valid() ? librdf_new_statement_from_statement(other.c_obj()) : 0;
+        }
+        return *this;
+    }
+
+    Statement(const World &world, Node subject, Node predicate, Node object)
+        : CObjWrapper(librdf_new_statement_from_nodes(world.c_obj(), subject.release(), predicate.release(), object.release()))
+    {
+        if (!c_obj_)
+            throw AllocException("librdf_new_statement_from_nodes");
+    }
+
+    ~Statement()
+    {
+        librdf_free_statement(c_obj_);
+    }
+
+    Node get_subject() const
+    {
+        if (is_valid())
+        {
+            if (librdf_node *n = librdf_statement_get_subject(c_obj_))
+                return Node(librdf_new_node_from_node(n));
+        }
+        return Node();
+    }
+
+    Node get_predicate() const
+    {
+        if (is_valid())
+        {
+            if (librdf_node *n = librdf_statement_get_predicate(c_obj_))
+                return Node(librdf_new_node_from_node(n));
+        }
+        return Node();
+    }
+
+    Node get_object() const
+    {
+        if (is_valid())
+        {
+            if (librdf_node *n = librdf_statement_get_object(c_obj_))
                 return Node(librdf_new_node_from_node(n));
         }
         return Node();
     }
 
+    /**
+     * Views of the statement parts, valid as long as the statement is not
+     * modified or freed
+     */
+    NodeView subject_view() const
+    {
+        return NodeView(is_valid() ? librdf_statement_get_subject(c_obj_) : 0);
+    }
+
+    NodeView predicate_view() const
+    {
+        return NodeView(is_valid() ? librdf_statement_get_predicate(c_obj_) : 0);
+    }
+
+    NodeView object_view() const
+    {
+        return NodeView(is_valid() ? librdf_statement_get_object(c_obj_) : 0);
+    }
+
     void set_subject(Node node)
     {
         librdf_statement_set_subject(c_obj_, node.release());
@@ -633,6 +1400,84 @@ public:
         librdf_statement_set_object(c_obj_, node.release());
     }
 
+    bool operator==(const Statement &other) const
+    {
+        if (c_obj_ == other.c_obj_)
+            return true;
+        if (!c_obj_ || !other.c_obj_)
+            return false;
+        return librdf_statement_equals(c_obj_, other.c_obj_) != 0;
+    }
+
+    bool operator!=(const Statement &other) const
+    {
+        return !operator==(other);
+    }
+
+    /**
+     * Hash of subject, predicate and object content, consistent with operator==
+     */
+    std::size_t hash() const
+    {
+        if (!c_obj_)
+            return 0;
+        NodeHash node_hash;
+        std::size_t h = node_hash(librdf_statement_get_subject(c_obj_));
+        h = h * 31 + node_hash(librdf_statement_get_predicate(c_obj_));
+        h = h * 31 + node_hash(librdf_statement_get_object(c_obj_));
+        return h;
+    }
+
+};
+
+/**
+ * Statement borrowing its nodes, for use as a reusable scratch buffer.
+ *
+ * The statement lives inside the object, so neither setting nodes nor
+ * passing it to a model allocates or touches reference counts. The nodes
+ * must outlive every use of the statement. librdf storages copy what they
+ * keep, so the nodes may be freed after an add_statement call.
+ */
+class StatementRef
+{
+public:
+
+    explicit StatementRef(const World &world)
+    {
+        librdf_statement_init(world.c_obj(), &statement_);
+    }
+
+    StatementRef(const World &world, librdf_node *subject, librdf_node *predicate, librdf_node *object)
+    {
+        librdf_statement_init(world.c_obj(), &statement_);
+        set(subject, predicate, object);
+    }
+
+    StatementRef(const StatementRef &) = delete;
+    StatementRef & operator=(const StatementRef &) = delete;
+
+    void set(librdf_node *subject, librdf_node *predicate, librdf_node *object)
+    {
+        statement_.subject = subject;
+        statement_.predicate = predicate;
+        statement_.object = object;
+    }
+
+    void set(const Node &subject, const Node &predicate, const Node &object)
+    {
+        set(subject.c_obj(), predicate.c_obj(), object.c_obj());
+    }
+
+    void set_subject(const Node &node) { statement_.subject = node.c_obj(); }
+
+    void set_predicate(const Node &node) { statement_.predicate = node.c_obj(); }
+
+    void set_object(const Node &node) { statement_.object = node.c_obj(); }
+
+    librdf_statement * c_obj() const { return &statement_; }
+
+private:
+    mutable librdf_statement statement_;
 };
 
 /**
@@ -898,85 +1743,514 @@ private:
     };
 };
 
-
-class Model : public CObjWrapper<librdf_model>
+/**
+ * Estimated memory used by a model, in bytes.
+ */
+struct MemoryStats
 {
-public:
-
-    Model(const World &world, const Storage &storage, const char *options_string)
-        : CObjWrapper(librdf_new_model(world.c_obj(), storage.c_obj(), options_string))
-        , world_(&world)
+    std::size_t num_statements;
+    std::size_t num_nodes;
+    std::size_t num_literals;
+    /** URI and blank node terms including their strings */
+    std::size_t node_bytes;
+    /** Literal terms including value, language and datatype */
+    std::size_t literal_bytes;
+    std::size_t statement_bytes;
+    std::size_t index_bytes;
+
+    MemoryStats()
+        : num_statements(0), num_nodes(0), num_literals(0)
+        , node_bytes(0), literal_bytes(0), statement_bytes(0), index_bytes(0)
     { }
 
-    Model(Model && other)
-        : CObjWrapper(std::move(other))
-        , world_(other.world_)
+    std::size_t total_bytes() const
     {
+        return node_bytes + literal_bytes + statement_bytes + index_bytes;
     }
 
-    const World & get_world() const { return *world_; }
-
-    Model & operator=(Model && other)
+    double bytes_per_triple() const
     {
-        librdf_free_model(c_obj_);
-        c_obj_ = 0;
-        world_ = other.world_;
-        return static_cast<Model&>(CObjWrapper::operator=(std::move(other)));
+        return num_statements ? double(total_bytes()) / num_statements : 0.0;
     }
+};
 
-    Model & operator=(const Model & other)
+/**
+ * Sizes of librdf structures used for memory estimates. librdf has neither
+ * allocator hooks nor storage bookkeeping, the defaults follow librdf
+ * 1.0.17 with raptor 2. num_indexes is the number of hashes of the
+ * storage, each holding the encoded statement as key and value: 3 for
+ * "hashes" (sp2o, po2s, so2p), 4 with contexts, 0 for the "memory" list.
+ */
+struct MemoryLayout
+{
+    unsigned num_indexes;
+    /** librdf_hash_memory_node and its value node */
+    std::size_t hash_entry_bytes;
+    /** raptor_uri: world, string, length, usage */
+    std::size_t uri_bytes;
+    std::size_t node_bytes;
+    std::size_t statement_bytes;
+
+    MemoryLayout(unsigned num_indexes = 3)
+        : num_indexes(num_indexes)
+        , hash_entry_bytes(8 * sizeof(void *))
+        , uri_bytes(4 * sizeof(void *))
+        , node_bytes(sizeof(librdf_node))
+        , statement_bytes(sizeof(librdf_statement))
+    { }
+
+    /**
+     * Size of node as encoded by librdf_node_encode, term_bytes is set to
+     * the node including the heap memory of its strings.
+     */
+    std::size_t encoded_size(librdf_node *node, std::size_t &term_bytes) const
     {
-        if (this != &other)
+        size_t length = 0;
+        term_bytes = node_bytes;
+        switch (librdf_node_get_type(node))
         {
-            librdf_free_model(c_obj_);
-            c_obj_ = other.is_valid() ? librdf_new_model_from_model(other.c_obj()) : 0;
-            world_ = other.world_;
+            case LIBRDF_NODE_TYPE_RESOURCE:
+                librdf_uri_as_counted_string(librdf_node_get_uri(node), &length);
+                term_bytes += uri_bytes + length + 1;
+                return 3 + length + 1;
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                librdf_node_get_literal_value_as_counted_string(node, &length);
+                std::size_t encoded = 6 + length + 1;
+                term_bytes += length + 1;
+                if (const char *language = librdf_node_get_literal_value_language(node))
+                {
+                    const std::size_t language_length = std::strlen(language);
+                    encoded += language_length + 1;
+                    term_bytes += language_length + 1;
+                }
+                if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                {
+                    librdf_uri_as_counted_string(datatype, &length);
+                    encoded += length + 1;
+                    // datatype URIs are shared by the world
+                }
+                return encoded;
+            }
+            case LIBRDF_NODE_TYPE_BLANK:
+                librdf_node_get_counted_blank_identifier(node, &length);
+                term_bytes += length + 1;
+                return 3 + length + 1;
+            default:
+                return 1;
         }
-        return *this;
-    }
-
-    ~Model()
-    {
-        librdf_free_model(c_obj_);
     }
+};
 
-    bool add_statement(const Statement &statement)
-    {
-        return librdf_model_add_statement(c_obj_, statement.c_obj()) == 0;
+/**
+ * Memory estimate updated statement by statement. Every distinct term is
+ * counted once, as the world shares URIs, so the terms are reference
+ * counted in a hash of node copies.
+ */
+class MemoryEstimate
+{
+public:
+
+    explicit MemoryEstimate(const MemoryLayout &layout = MemoryLayout())
+        : layout_(layout)
+    { }
+
+    MemoryEstimate(const MemoryEstimate &) = delete;
+    MemoryEstimate & operator=(const MemoryEstimate &) = delete;
+
+    ~MemoryEstimate()
+    {
+        clear();
+    }
+
+    const MemoryLayout & layout() const { return layout_; }
+
+    const MemoryStats & stats() const { return stats_; }
+
+    void add(librdf_statement *statement)
+    {
+        update(statement, true);
+    }
+
+    void remove(librdf_statement *statement)
+    {
+        update(statement, false);
+    }
+
+    void clear()
+    {
+        for (TermCounts::iterator it = terms_.begin(); it != terms_.end(); ++it)
+            librdf_free_node(it->first);
+        terms_.clear();
+        stats_ = MemoryStats();
+    }
+
+private:
+
+    typedef std::unordered_map<librdf_node *, std::size_t, NodeHash, NodeEqual> TermCounts;
+
+    void update(librdf_statement *statement, bool added)
+    {
+        librdf_node *terms[3] = {
+            librdf_statement_get_subject(statement),
+            librdf_statement_get_predicate(statement),
+            librdf_statement_get_object(statement)
+        };
+        std::size_t encoded = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (!terms[i])
+                continue;
+            std::size_t term_bytes = 0;
+            encoded += layout_.encoded_size(terms[i], term_bytes);
+            if (added ? add_term(terms[i]) : remove_term(terms[i]))
+                account(librdf_node_is_literal(terms[i]) != 0, term_bytes, added);
+        }
+        const std::size_t index_bytes = layout_.num_indexes * (encoded + layout_.hash_entry_bytes);
+        if (added)
+        {
+            stats_.num_statements++;
+            stats_.statement_bytes += layout_.statement_bytes;
+            stats_.index_bytes += index_bytes;
+        }
+        else if (stats_.num_statements)
+        {
+            stats_.num_statements--;
+            stats_.statement_bytes -= std::min(stats_.statement_bytes, layout_.statement_bytes);
+            stats_.index_bytes -= std::min(stats_.index_bytes, index_bytes);
+        }
+    }
+
+    /** True when node is a new term */
+    bool add_term(librdf_node *node)
+    {
+        TermCounts::iterator it = terms_.find(node);
+        if (it != terms_.end())
+        {
+            ++it->second;
+            return false;
+        }
+        librdf_node *copy = librdf_new_node_from_node(node);
+        if (!copy)
+            throw AllocException("librdf_new_node_from_node");
+        terms_.insert(std::make_pair(copy, std::size_t(1)));
+        return true;
+    }
+
+    /** True when the last use of node is gone */
+    bool remove_term(librdf_node *node)
+    {
+        TermCounts::iterator it = terms_.find(node);
+        if (it == terms_.end() || --it->second != 0)
+            return false;
+        librdf_node *copy = it->first;
+        terms_.erase(it);
+        librdf_free_node(copy);
+        return true;
+    }
+
+    void account(bool literal, std::size_t bytes, bool added)
+    {
+        std::size_t &count = literal ? stats_.num_literals : stats_.num_nodes;
+        std::size_t &total = literal ? stats_.literal_bytes : stats_.node_bytes;
+        if (added)
+        {
+            ++count;
+            total += bytes;
+        }
+        else
+        {
+            --count;
+            total -= std::min(total, bytes);
+        }
+    }
+
+    MemoryLayout layout_;
+    MemoryStats stats_;
+    TermCounts terms_;
+};
+
+class Model;
+
+/**
+ * Receives the statements added to and removed from a Model through its
+ * add_statement and remove_statement methods. A model can have several
+ * listeners, see Model::add_listener.
+ */
+class StatementListener
+{
+public:
+
+    virtual ~StatementListener() { }
+
+    virtual void statement_added(librdf_statement *statement) = 0;
+
+    virtual void statement_removed(librdf_statement *statement) = 0;
+
+    /**
+     * The model the listener is set on was moved to model, or model is 0
+     * when the model was destroyed or the listener was replaced.
+     */
+    virtual void model_relocated(Model *model) { (void)model; }
+};
+
+/**
+ * Storage module which reports its own changes to a StatementListener.
+ * A Model with a listener on such a storage leaves the reporting to the
+ * storage, so its writes need no presence checks. Implementations
+ * register the librdf_storage they back while it exists.
+ */
+class ReportingStorage
+{
+public:
+
+    virtual ~ReportingStorage() { }
+
+    /**
+     * Report statements really added or removed to listener, 0 to stop.
+     * A Model sets a single listener forwarding to all of its listeners.
+     */
+    virtual void set_listener(StatementListener *listener) = 0;
+
+    /** Implementation backing storage, or 0 if it does not report */
+    static ReportingStorage * find(librdf_storage *storage)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        Registry::const_iterator it = registry().find(storage);
+        return it != registry().end() ? it->second : 0;
+    }
+
+protected:
+
+    static void register_storage(librdf_storage *storage, ReportingStorage *instance)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry()[storage] = instance;
+    }
+
+    static void unregister_storage(librdf_storage *storage)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry().erase(storage);
+    }
+
+private:
+
+    typedef std::unordered_map<librdf_storage *, ReportingStorage *> Registry;
+
+    static Registry & registry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    static std::mutex & registry_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+};
+
+class Model : public CObjWrapper<librdf_model>
+{
+public:
+
+    Model(const World &world, const Storage &storage, const char *options_string)
+        : CObjWrapper(librdf_new_model(world.c_obj(), storage.c_obj(), options_string))
+        , world_(&world)
+        , reporting_storage_(0)
+    { }
+
+    Model(Model && other)
+        : CObjWrapper(std::move(other))
+        , world_(other.world_)
+        , listeners_(std::move(other.listeners_))
+        , reporting_storage_(other.reporting_storage_)
+    {
+        other.reporting_storage_ = 0;
+        if (listeners_)
+            listeners_->model_relocated(this);
+    }
+
+    const World & get_world() const { return *world_; }
+
+    Model & operator=(Model && other)
+    {
+        if (this == &other)
+            return *this;
+        clear_listeners();
+        librdf_free_model(c_obj_);
+        c_obj_ = 0;
+        world_ = other.world_;
+        listeners_ = std::move(other.listeners_);
+        reporting_storage_ = other.reporting_storage_;
+        other.reporting_storage_ = 0;
+        if (listeners_)
+            listeners_->model_relocated(this);
+        return static_cast<Model&>(CObjWrapper::operator=(std::move(other)));
+    }
+
+    Model & operator=(const Model & other)
+    {
+        if (this != &other)
+        {
+            clear_listeners();
+            librdf_free_model(c_obj_);
+            c_obj_ = other.is_valid() ? librdf_new_model_from_model(other.c_obj()) : 0;
+            world_ = other.world_;
+        }
+        return *this;
+    }
+
+    ~Model()
+    {
+        clear_listeners();
+        librdf_free_model(c_obj_);
+    }
+
+    /**
+     * Notify listener about added and removed statements, until it is
+     * removed. With listeners every add and remove checks whether the
+     * triple is present, so only real changes are reported: a triple is
+     * added when it was in no context before and removed when it is in no
+     * context afterwards. The checks are made once per write, however many
+     * listeners there are. A ReportingStorage, like ColumnarStorage,
+     * reports its changes itself, which saves the checks and also covers
+     * writes made with librdf directly.
+     *
+     * Listeners follow the model when it is moved and are told through
+     * model_relocated, a removed listener gets model_relocated(0).
+     */
+    void add_listener(StatementListener *listener)
+    {
+        if (!listener || (listeners_ && listeners_->contains(listener)))
+            return;
+        if (!listeners_)
+            listeners_.reset(new Listeners());
+        if (listeners_->empty() && c_obj_)
+        {
+            // the storage lookup is only needed for the first listener
+            reporting_storage_ = ReportingStorage::find(librdf_model_get_storage(c_obj_));
+            if (reporting_storage_)
+                reporting_storage_->set_listener(listeners_.get());
+        }
+        listeners_->add(listener);
+    }
+
+    void remove_listener(StatementListener *listener)
+    {
+        if (!listeners_ || !listeners_->remove(listener))
+            return;
+        if (listeners_->empty() && reporting_storage_)
+        {
+            reporting_storage_->set_listener(0);
+            reporting_storage_ = 0;
+        }
+        listener->model_relocated(0);
+    }
+
+    bool has_listener(StatementListener *listener) const
+    {
+        return listeners_ && listeners_->contains(listener);
+    }
+
+    /**
+     * True when listeners learn about changes only from the Model methods,
+     * writes made with librdf directly are then not reported.
+     */
+    bool model_reports() const { return listeners_ && !listeners_->empty() && !reporting_storage_; }
+
+    /**
+     * Add all statements of stream. When the Model reports to its listeners
+     * the statements are added one by one like add_statement, into the
+     * context of the stream when the model supports contexts.
+     */
+    bool add_statements(Stream &stream)
+    {
+        if (!model_reports())
+            return librdf_model_add_statements(c_obj_, stream.c_obj()) == 0;
+        const bool contexts = supports_contexts();
+        bool ok = true;
+        for (; !stream.is_end(); stream.next())
+        {
+            librdf_statement *statement = librdf_stream_get_object(stream.c_obj());
+            if (!statement)
+                continue;
+            librdf_node *context = contexts ? librdf_stream_get_context2(stream.c_obj()) : 0;
+            ok = (context ? add(context, statement) : add(statement)) && ok;
+        }
+        return ok;
+    }
+
+    bool add_statement(const Statement &statement)
+    {
+        return add(statement.c_obj());
     }
 
     bool add_statement(const Node &context, const Statement &statement)
     {
-        return librdf_model_context_add_statement(c_obj_, context.c_obj(), statement.c_obj()) == 0;
+        return add(context.c_obj(), statement.c_obj());
+    }
+
+    bool add_statement(const StatementRef &statement)
+    {
+        return add(statement.c_obj());
+    }
+
+    bool add_statement(const Node &context, const StatementRef &statement)
+    {
+        return add(context.c_obj(), statement.c_obj());
     }
 
+    /**
+     * Add a statement borrowing the nodes, no statement or node is allocated
+     * besides what the storage keeps.
+     */
+    bool add_statement(const Node &subject, const Node &predicate, const Node &object)
+    {
+        return add_statement(StatementRef(*world_, subject.c_obj(), predicate.c_obj(), object.c_obj()));
+    }
+
+    /**
+     * Arguments which are not nodes are converted to temporary nodes, nodes
+     * are borrowed.
+     */
     template <class N1, class N2, class N3>
     bool add_statement(const World &world, N1 &&subject, N2 &&predicate, N3 &&object)
     {
-        return add_statement(Statement(world,
-            std::forward<N1>(subject),
-            std::forward<N2>(predicate),
-            std::forward<N3>(object)));
+        const Node &s = subject;
+        const Node &p = predicate;
+        const Node &o = object;
+        return add_statement(StatementRef(world, s.c_obj(), p.c_obj(), o.c_obj()));
     }
 
     template <class N1, class N2, class N3, class N4>
     bool add_statement(const World &world, N1 &&context, N2 &&subject, N3 &&predicate, N4 &&object)
     {
-        return add_statement(std::forward<N1>(context),
-            Statement(world,
-            std::forward<N2>(subject),
-            std::forward<N3>(predicate),
-            std::forward<N4>(object)));
+        const Node &s = subject;
+        const Node &p = predicate;
+        const Node &o = object;
+        return add_statement(context, StatementRef(world, s.c_obj(), p.c_obj(), o.c_obj()));
     }
 
     bool remove_statement(const Statement &statement)
     {
-        return librdf_model_remove_statement(c_obj_, statement.c_obj()) == 0;
+        return remove(statement.c_obj());
+    }
+
+    bool remove_statement(const StatementRef &statement)
+    {
+        return remove(statement.c_obj());
     }
 
     bool remove_statement(const Node &context, const Statement &statement)
     {
-        return librdf_model_context_remove_statement(c_obj_, context.c_obj(), statement.c_obj()) == 0;
+        return remove(context.c_obj(), statement.c_obj());
+    }
+
+    bool remove_statement(const Node &context, const StatementRef &statement)
+    {
+        return remove(context.c_obj(), statement.c_obj());
     }
 
     Stream get_context_as_stream(const Node &context) const
@@ -986,7 +2260,20 @@ public:
 
     bool remove_context_statements(const Node &context)
     {
-        return librdf_model_context_remove_statements(c_obj_, context.c_obj()) == 0;
+        std::vector<Statement> removed;
+        if (model_reports())
+        {
+            Stream stream(get_context_as_stream(context));
+            if (stream.is_valid())
+                stream.copy(std::back_inserter(removed));
+        }
+        if (librdf_model_context_remove_statements(c_obj_, context.c_obj()) != 0)
+            return false;
+        // the triples may still be stored in other contexts
+        for (std::vector<Statement>::const_iterator it = removed.begin(); it != removed.end(); ++it)
+            if (librdf_model_contains_statement(c_obj_, it->c_obj()) == 0)
+                listeners_->statement_removed(it->c_obj());
+        return true;
     }
 
     void remove_all_statements()
@@ -997,7 +2284,7 @@ public:
             librdf_statement * stmt = librdf_stream_get_object(sr);
             if (stmt)
             {
-                librdf_model_remove_statement(c_obj(), stmt);
+                remove(stmt);
             }
         }
         librdf_free_stream(sr);
@@ -1031,6 +2318,14 @@ public:
         return found;
     }
 
+    bool has_statement(const StatementRef &statement) const
+    {
+        librdf_stream *sr = librdf_model_find_statements(c_obj(), statement.c_obj());
+        bool found = !librdf_stream_end(sr);
+        librdf_free_stream(sr);
+        return found;
+    }
+
     template <class OutputIt, class Size>
     OutputIt find_statements(OutputIt first, Size count, const Statement &statement) const
     {
@@ -1041,57 +2336,591 @@ public:
         return first;
     }
 
-    template <class OutputIt>
-    OutputIt find_statements(OutputIt first, const Statement &statement) const
-    {
-        if (librdf_stream *sr = librdf_model_find_statements(c_obj_, statement.c_obj()))
-        {
-            return Stream(sr).copy(first);
-        }
-        return first;
-    }
+    template <class OutputIt>
+    OutputIt find_statements(OutputIt first, const Statement &statement) const
+    {
+        if (librdf_stream *sr = librdf_model_find_statements(c_obj_, statement.c_obj()))
+        {
+            return Stream(sr).copy(first);
+        }
+        return first;
+    }
+
+    Statement find_statement(const Statement &statement) const
+    {
+        Statement stmt;
+        if (librdf_stream *sr = librdf_model_find_statements(c_obj(), statement.c_obj()))
+        {
+            Stream stream(sr);
+            if (!stream.is_end())
+                stmt = std::move(stream.get_object());
+        }
+        return stmt;
+    }
+
+    Statement find_statement(const World &world, Node subject, Node predicate, Node object)
+    {
+        return find_statement(Statement(world, subject, predicate, object));
+    }
+
+    std::vector<Statement> find_statements(const Statement &statement) const
+    {
+        std::vector<Statement> result;
+        find_statements(std::back_inserter<std::vector<Statement> >(result), statement);
+        return result;
+    }
+
+    std::vector<Statement> find_statements(const World &world, Node subject, Node predicate, Node object) const
+    {
+        return find_statements(Statement(world, subject, predicate, object));
+    }
+
+    Stream find_statements_as_stream(const Statement &statement) const
+    {
+        return Stream(librdf_model_find_statements(c_obj(), statement.c_obj()));
+    }
+
+    Stream find_statements_in_context(const Statement &statement, const Node &context_node)
+    {
+        return Stream(librdf_model_find_statements_in_context(c_obj_, statement.c_obj(), context_node.c_obj()));
+    }
+
+    /**
+     * Estimate memory used by the model with one scan over its statements,
+     * see MemoryLayout. MemoryTracker keeps the same estimate up to date as
+     * statements are added and removed, without scans.
+     */
+    MemoryStats memory_stats(const MemoryLayout &layout = MemoryLayout()) const
+    {
+        MemoryEstimate estimate(layout);
+        Stream stream(as_stream());
+        for (; stream.is_valid() && !stream.is_end(); stream.next())
+        {
+            if (librdf_statement *statement = librdf_stream_get_object(stream.c_obj()))
+                estimate.add(statement);
+        }
+        return estimate.stats();
+    }
+
+private:
+
+    bool add(librdf_statement *statement)
+    {
+        if (!model_reports())
+            return librdf_model_add_statement(c_obj_, statement) == 0;
+        const bool present = librdf_model_contains_statement(c_obj_, statement) != 0;
+        if (librdf_model_add_statement(c_obj_, statement) != 0)
+            return false;
+        if (!present)
+            listeners_->statement_added(statement);
+        return true;
+    }
+
+    bool add(librdf_node *context, librdf_statement *statement)
+    {
+        if (!model_reports())
+            return librdf_model_context_add_statement(c_obj_, context, statement) == 0;
+        const bool present = librdf_model_contains_statement(c_obj_, statement) != 0;
+        if (librdf_model_context_add_statement(c_obj_, context, statement) != 0)
+            return false;
+        if (!present)
+            listeners_->statement_added(statement);
+        return true;
+    }
+
+    bool remove(librdf_statement *statement)
+    {
+        if (!model_reports())
+            return librdf_model_remove_statement(c_obj_, statement) == 0;
+        const bool present = librdf_model_contains_statement(c_obj_, statement) != 0;
+        if (librdf_model_remove_statement(c_obj_, statement) != 0)
+            return false;
+        if (present && librdf_model_contains_statement(c_obj_, statement) == 0)
+            listeners_->statement_removed(statement);
+        return true;
+    }
+
+    bool remove(librdf_node *context, librdf_statement *statement)
+    {
+        if (!model_reports())
+            return librdf_model_context_remove_statement(c_obj_, context, statement) == 0;
+        const bool present = librdf_model_contains_statement(c_obj_, statement) != 0;
+        if (librdf_model_context_remove_statement(c_obj_, context, statement) != 0)
+            return false;
+        if (present && librdf_model_contains_statement(c_obj_, statement) == 0)
+            listeners_->statement_removed(statement);
+        return true;
+    }
+
+    /** Forwards to every listener of the model */
+    class Listeners : public StatementListener
+    {
+    public:
+
+        bool empty() const { return listeners_.empty(); }
+
+        bool contains(StatementListener *listener) const
+        {
+            return std::find(listeners_.begin(), listeners_.end(), listener) != listeners_.end();
+        }
+
+        void add(StatementListener *listener)
+        {
+            listeners_.push_back(listener);
+        }
+
+        bool remove(StatementListener *listener)
+        {
+            std::vector<StatementListener *>::iterator it = std::find(listeners_.begin(), listeners_.end(), listener);
+            if (it == listeners_.end())
+                return false;
+            listeners_.erase(it);
+            return true;
+        }
+
+        /** Remove all listeners and return them */
+        std::vector<StatementListener *> take()
+        {
+            std::vector<StatementListener *> result;
+            result.swap(listeners_);
+            return result;
+        }
+
+        virtual void statement_added(librdf_statement *statement)
+        {
+            for (std::size_t i = 0; i < listeners_.size(); ++i)
+                listeners_[i]->statement_added(statement);
+        }
+
+        virtual void statement_removed(librdf_statement *statement)
+        {
+            for (std::size_t i = 0; i < listeners_.size(); ++i)
+                listeners_[i]->statement_removed(statement);
+        }
+
+        virtual void model_relocated(Model *model)
+        {
+            for (std::size_t i = 0; i < listeners_.size(); ++i)
+                listeners_[i]->model_relocated(model);
+        }
+
+    private:
+        std::vector<StatementListener *> listeners_;
+    };
+
+    void clear_listeners()
+    {
+        if (!listeners_)
+            return;
+        if (reporting_storage_)
+        {
+            reporting_storage_->set_listener(0);
+            reporting_storage_ = 0;
+        }
+        const std::vector<StatementListener *> removed = listeners_->take();
+        for (std::size_t i = 0; i < removed.size(); ++i)
+            removed[i]->model_relocated(0);
+    }
+
+    const World * world_;
+    // allocated once, so storages keep a stable pointer when the model moves
+    std::unique_ptr<Listeners> listeners_;
+    ReportingStorage * reporting_storage_;
+};
+
+/**
+ * Query results, read row by row.
+ * http://librdf.org/docs/api/redland-query-results.html
+ */
+class QueryResults : public CObjWrapper<librdf_query_results>
+{
+public:
+
+    QueryResults()
+        : CObjWrapper(0)
+    { }
+
+    /**
+     * Take ownership of results, query is kept alive as long as the results.
+     */
+    explicit QueryResults(librdf_query_results *results,
+                          std::shared_ptr<librdf_query> query = std::shared_ptr<librdf_query>())
+        : CObjWrapper(results)
+        , query_(std::move(query))
+    { }
+
+    QueryResults(const QueryResults &other) = delete;
+
+    QueryResults(QueryResults && other)
+        : CObjWrapper(std::move(other))
+        , row_(std::move(other.row_))
+        , fetched_(std::move(other.fetched_))
+        , query_(std::move(other.query_))
+    {
+    }
+
+    ~QueryResults()
+    {
+        librdf_free_query_results(c_obj_);
+    }
+
+    QueryResults & operator=(QueryResults && other)
+    {
+        librdf_free_query_results(c_obj_);
+        c_obj_ = 0;
+        row_ = std::move(other.row_);
+        fetched_ = std::move(other.fetched_);
+        query_ = std::move(other.query_);
+        return static_cast<QueryResults&>(CObjWrapper::operator=(std::move(other)));
+    }
+
+    QueryResults & operator=(const QueryResults & other) = delete;
+
+    bool is_bindings() const { return c_obj_ && librdf_query_results_is_bindings(c_obj_) != 0; }
+
+    bool is_boolean() const { return c_obj_ && librdf_query_results_is_boolean(c_obj_) != 0; }
+
+    bool is_graph() const { return c_obj_ && librdf_query_results_is_graph(c_obj_) != 0; }
+
+    /** Result of an ASK query */
+    bool get_boolean() const
+    {
+        return c_obj_ && librdf_query_results_get_boolean(c_obj_) > 0;
+    }
+
+    /** Statements of a CONSTRUCT or DESCRIBE query */
+    Stream as_stream() const
+    {
+        return Stream(librdf_query_results_as_stream(c_obj_));
+    }
+
+    bool is_finished() const
+    {
+        return !c_obj_ || librdf_query_results_finished(c_obj_) != 0;
+    }
+
+    /** Advance to the next row, false when there is none */
+    bool next()
+    {
+        std::fill(fetched_.begin(), fetched_.end(), 0);
+        return librdf_query_results_next(c_obj_) == 0;
+    }
+
+    /** Number of rows read so far */
+    int count() const
+    {
+        return librdf_query_results_get_count(c_obj_);
+    }
+
+    int num_bindings() const
+    {
+        return c_obj_ ? librdf_query_results_get_bindings_count(c_obj_) : 0;
+    }
+
+    StringRef binding_name(int offset) const
+    {
+        const char *name = librdf_query_results_get_binding_name(c_obj_, offset);
+        return name ? StringRef(name) : StringRef();
+    }
+
+    /** Offset of the binding called name, -1 when there is none */
+    int binding_index(StringRef name) const
+    {
+        const int n = num_bindings();
+        for (int i = 0; i < n; ++i)
+        {
+            if (binding_name(i) == name)
+                return i;
+        }
+        return -1;
+    }
+
+    /**
+     * Value of a binding in the current row, invalid when unbound. librdf
+     * creates a node per value, it is only created for bindings which are
+     * read and is owned by the results until next().
+     */
+    NodeView value(int offset) const
+    {
+        if (offset < 0 || offset >= num_bindings())
+            return NodeView();
+        if (row_.size() != static_cast<std::size_t>(num_bindings()))
+        {
+            row_.resize(num_bindings());
+            fetched_.assign(num_bindings(), 0);
+        }
+        if (!fetched_[offset])
+        {
+            row_[offset] = Node(librdf_query_results_get_binding_value(c_obj_, offset));
+            fetched_[offset] = 1;
+        }
+        return row_[offset].view();
+    }
+
+    NodeView value(StringRef name) const
+    {
+        return value(binding_index(name));
+    }
+
+private:
+    mutable std::vector<Node> row_;
+    mutable std::vector<char> fetched_;
+    std::shared_ptr<librdf_query> query_;
+};
+
+/**
+ * Query, parsed and prepared on the first execution and reused by later
+ * ones. The default language is SPARQL 1.1. Results keep the query alive.
+ *
+ * librdf keeps a single results object per query and frees it on the next
+ * execution, so execute() parses a new librdf query while results of the
+ * previous one are still alive. Reusing a query is parse free only when
+ * its earlier results were destroyed.
+ * http://librdf.org/docs/api/redland-query.html
+ */
+class Query : public CObjWrapper<librdf_query>
+{
+public:
+
+    Query(const World &world, const std::string &query_string, const char *language = "sparql11-query",
+          const char *base_uri = 0)
+        : CObjWrapper(0)
+        , world_(&world)
+        , text_(query_string)
+        , language_(language)
+        , base_uri_(base_uri ? base_uri : "")
+        , has_base_uri_(base_uri != 0)
+        , num_parsed_(0)
+    {
+        parse();
+    }
+
+    Query(const Query &other) = delete;
+
+    Query(Query && other)
+        : CObjWrapper(std::move(other))
+        , world_(other.world_)
+        , text_(std::move(other.text_))
+        , language_(std::move(other.language_))
+        , base_uri_(std::move(other.base_uri_))
+        , has_base_uri_(other.has_base_uri_)
+        , num_parsed_(other.num_parsed_)
+        , owner_(std::move(other.owner_))
+    {
+    }
+
+    Query & operator=(Query && other)
+    {
+        world_ = other.world_;
+        text_ = std::move(other.text_);
+        language_ = std::move(other.language_);
+        base_uri_ = std::move(other.base_uri_);
+        has_base_uri_ = other.has_base_uri_;
+        num_parsed_ = other.num_parsed_;
+        owner_ = std::move(other.owner_);
+        c_obj_ = 0;
+        return static_cast<Query&>(CObjWrapper::operator=(std::move(other)));
+    }
+
+    Query & operator=(const Query & other) = delete;
+
+    /** Number of times the query was parsed */
+    std::size_t num_parsed() const { return num_parsed_; }
+
+    /** Results are invalid when the query fails */
+    QueryResults execute(const Model &model)
+    {
+        // earlier results read through the query, executing it again would free them
+        if (owner_.use_count() > 1)
+            parse();
+        return QueryResults(librdf_query_execute(c_obj_, model.c_obj()), owner_);
+    }
+
+private:
+    // owner_ frees the query, it can not be released
+    using CObjWrapper::release;
+
+    void parse()
+    {
+        Uri base(has_base_uri_ ? Uri(*world_, base_uri_.c_str()) : Uri());
+        std::shared_ptr<librdf_query> query(librdf_new_query(world_->c_obj(), language_.c_str(), 0,
+            reinterpret_cast<const unsigned char *>(text_.c_str()), base.c_obj()), &librdf_free_query);
+        if (!query)
+            throw AllocException("librdf_new_query");
+        owner_.swap(query);
+        c_obj_ = owner_.get();
+        ++num_parsed_;
+    }
+
+    const World *world_;
+    std::string text_;
+    std::string language_;
+    std::string base_uri_;
+    bool has_base_uri_;
+    std::size_t num_parsed_;
+    // shared with the results
+    std::shared_ptr<librdf_query> owner_;
+};
+
+/**
+ * Query executed many times with different variable values.
+ *
+ * This is not a prepared statement: librdf has no API for binding query
+ * variables, so values are passed as a SPARQL 1.1 VALUES clause appended
+ * to the query, and every set of values not seen before costs a full
+ * parse of the query. The last max_prepared value sets are kept parsed,
+ * so executions with recurring values are parse free, while a workload
+ * with ever changing values parses on every execution just like Query.
+ * redland_query_test prints both costs. Blank nodes can not be bound.
+ */
+class PreparedQuery
+{
+public:
+
+    /** language must accept SPARQL 1.1 VALUES */
+    PreparedQuery(const World &world, const std::string &query_string, const char *language = "sparql11-query",
+                  const char *base_uri = 0, std::size_t max_prepared = 64)
+        : world_(&world)
+        , text_(query_string)
+        , language_(language)
+        , base_uri_(base_uri ? base_uri : "")
+        , has_base_uri_(base_uri != 0)
+        , max_prepared_(max_prepared ? max_prepared : 1)
+        , num_parsed_(0)
+    { }
 
-    Statement find_statement(const Statement &statement) const
+    /** Bind variable name, without '?', false when value can not be bound */
+    bool bind(const std::string &name, const Node &value)
     {
-        Statement stmt;
-        if (librdf_stream *sr = librdf_model_find_statements(c_obj(), statement.c_obj()))
-        {
-            Stream stream(sr);
-            if (!stream.is_end())
-                stmt = std::move(stream.get_object());
-        }
-        return stmt;
+        std::string term;
+        if (!append_term(term, value.view()))
+            return false;
+        bindings_[name] = term;
+        return true;
     }
 
-    Statement find_statement(const World &world, Node subject, Node predicate, Node object)
+    void unbind(const std::string &name)
     {
-        return find_statement(Statement(world, subject, predicate, object));
+        bindings_.erase(name);
     }
 
-    std::vector<Statement> find_statements(const Statement &statement) const
+    void clear_bindings()
     {
-        std::vector<Statement> result;
-        find_statements(std::back_inserter<std::vector<Statement> >(result), statement);
-        return result;
+        bindings_.clear();
     }
 
-    std::vector<Statement> find_statements(const World &world, Node subject, Node predicate, Node object) const
+    /** Number of value sets kept parsed */
+    std::size_t num_prepared() const { return prepared_.size(); }
+
+    /** Number of times the query was parsed */
+    std::size_t num_parsed() const { return num_parsed_; }
+
+    /**
+     * Execute with the current bindings, results keep the query alive. The
+     * query is parsed again when results of the same value set are still
+     * alive, see Query.
+     */
+    QueryResults execute(const Model &model)
     {
-        return find_statements(Statement(world, subject, predicate, object));
+        const std::shared_ptr<Query> query = prepare();
+        const std::size_t num_parsed = query->num_parsed();
+        QueryResults results(query->execute(model));
+        num_parsed_ += query->num_parsed() - num_parsed;
+        return results;
     }
 
-    Stream find_statements_as_stream(const Statement &statement) const
+private:
+
+    std::shared_ptr<Query> prepare()
     {
-        return Stream(librdf_model_find_statements(c_obj(), statement.c_obj()));
+        std::string clause;
+        if (!bindings_.empty())
+        {
+            std::string names, values;
+            for (std::map<std::string, std::string>::const_iterator it = bindings_.begin(); it != bindings_.end(); ++it)
+            {
+                names += " ?" + it->first;
+                values += ' ' + it->second;
+            }
+            clause = "\nVALUES (" + names + " ) {\n  (" + values + " )\n}\n";
+        }
+
+        Prepared::iterator it = prepared_.find(clause);
+        if (it != prepared_.end())
+        {
+            // most recently used first
+            recent_.splice(recent_.begin(), recent_, it->second);
+            return it->second->second;
+        }
+        std::shared_ptr<Query> query(new Query(*world_, text_ + clause, language_.c_str(),
+                                               has_base_uri_ ? base_uri_.c_str() : 0));
+        ++num_parsed_;
+        if (prepared_.size() >= max_prepared_)
+        {
+            prepared_.erase(recent_.back().first);
+            recent_.pop_back();
+        }
+        recent_.push_front(std::make_pair(clause, query));
+        prepared_.insert(std::make_pair(clause, recent_.begin()));
+        return query;
     }
 
-    Stream find_statements_in_context(const Statement &statement, const Node &context_node)
+    static bool append_term(std::string &out, NodeView node)
     {
-        return Stream(librdf_model_find_statements_in_context(c_obj_, statement.c_obj(), context_node.c_obj()));
+        if (node.is_resource())
+        {
+            const StringRef uri = node.uri();
+            out += '<';
+            out.append(uri.data(), uri.size());
+            out += '>';
+            return true;
+        }
+        if (!node.is_literal())
+            return false;
+        const StringRef value = node.literal_value();
+        out += '"';
+        for (StringRef::const_iterator c = value.begin(); c != value.end(); ++c)
+        {
+            switch (*c)
+            {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default: out += *c; break;
+            }
+        }
+        out += '"';
+        const StringRef language = node.language();
+        const StringRef datatype = node.datatype();
+        if (!language.empty())
+        {
+            out += '@';
+            out.append(language.data(), language.size());
+        }
+        else if (!datatype.empty())
+        {
+            out += "^^<";
+            out.append(datatype.data(), datatype.size());
+            out += '>';
+        }
+        return true;
     }
 
-private:
-    const World * world_;
+    const World *world_;
+    std::string text_;
+    std::string language_;
+    std::string base_uri_;
+    bool has_base_uri_;
+    typedef std::list<std::pair<std::string, std::shared_ptr<Query> > > Recent;
+    typedef std::unordered_map<std::string, Recent::iterator> Prepared;
+
+    std::size_t max_prepared_;
+    std::size_t num_parsed_;
+    std::map<std::string, std::string> bindings_;
+    Recent recent_;
+    Prepared prepared_;
 };
 
 raptor_iostream* raptor_new_iostream_from_std_istream(
@@ -1283,12 +3112,20 @@ class Parser : public CObjWrapper<librdf_parser>
 {
 public:
 
+    typedef std::function<void (const Statement &)> StatementHandler;
+
     Parser()
         : CObjWrapper(0)
+        , world_(0)
+        , push_parser_(0)
+        , push_failed_(false)
     { }
 
     Parser(librdf_parser *parser)
         : CObjWrapper(parser)
+        , world_(0)
+        , push_parser_(0)
+        , push_failed_(false)
     { }
 
     Parser(const World &world,
@@ -1296,6 +3133,11 @@ public:
            const char *mime_type = 0,
            const Uri &type_uri = Uri())
         : CObjWrapper(librdf_new_parser(world.c_obj(), name, mime_type, type_uri.c_obj()))
+        , world_(&world)
+        , name_(name ? name : "")
+        , mime_type_(mime_type ? mime_type : "")
+        , push_parser_(0)
+        , push_failed_(false)
     {
         if (!is_valid())
             throw AllocException("librdf_new_parser");
@@ -1305,18 +3147,40 @@ public:
 
     Parser(Parser && other)
         : CObjWrapper(std::move(other))
+        , world_(other.world_)
+        , name_(std::move(other.name_))
+        , mime_type_(std::move(other.mime_type_))
+        , push_parser_(other.push_parser_)
+        , push_failed_(other.push_failed_)
+        , statement_handler_(std::move(other.statement_handler_))
     {
+        other.push_parser_ = 0;
+        if (push_parser_)
+            raptor_parser_set_statement_handler(push_parser_, this, &Parser::handle_raptor_statement);
     }
 
     ~Parser()
     {
+        if (push_parser_)
+            raptor_free_parser(push_parser_);
         librdf_free_parser(c_obj_);
     }
 
     Parser & operator=(Parser && other)
     {
+        if (push_parser_)
+            raptor_free_parser(push_parser_);
         librdf_free_parser(c_obj_);
         c_obj_ = 0;
+        world_ = other.world_;
+        name_ = std::move(other.name_);
+        mime_type_ = std::move(other.mime_type_);
+        push_parser_ = other.push_parser_;
+        other.push_parser_ = 0;
+        if (push_parser_)
+            raptor_parser_set_statement_handler(push_parser_, this, &Parser::handle_raptor_statement);
+        push_failed_ = other.push_failed_;
+        statement_handler_ = std::move(other.statement_handler_);
         return static_cast<Parser&>(CObjWrapper::operator=(std::move(other)));
     }
 
@@ -1334,6 +3198,15 @@ public:
 
     bool parse_into_model(const Uri &uri, const Uri &base_uri, const Model &model)
     {
+        if (model.model_reports())
+            return parse_reported(model, base_uri, [&](raptor_parser *parser, raptor_uri *base)
+                {
+                    raptor_uri *source = new_raptor_uri(model, uri);
+                    const int result = source ? raptor_parser_parse_uri(parser, source, base) : 1;
+                    if (source)
+                        raptor_free_uri(source);
+                    return result;
+                });
         return librdf_parser_parse_into_model(c_obj_, uri.c_obj(), base_uri.c_obj(), model.c_obj()) == 0;
     }
 
@@ -1344,6 +3217,16 @@ public:
 
     bool parse_into_model(FILE *handle, bool close_fh, const Uri &base_uri, const Model &model)
     {
+        if (model.model_reports())
+        {
+            const bool result = parse_reported(model, base_uri, [&](raptor_parser *parser, raptor_uri *base)
+                {
+                    return raptor_parser_parse_file_stream(parser, handle, 0, base);
+                });
+            if (close_fh)
+                fclose(handle);
+            return result;
+        }
         return librdf_parser_parse_file_handle_into_model(c_obj_, handle, close_fh ? 1 : 0, base_uri.c_obj(), model.c_obj()) == 0;
     }
 
@@ -1359,6 +3242,8 @@ public:
 
     bool parse_into_model(const char *str, const Uri &base_uri, const Model &model)
     {
+        if (model.model_reports())
+            return parse_into_model(str, std::strlen(str), base_uri, model);
         return librdf_parser_parse_string_into_model(
             c_obj_, reinterpret_cast<const unsigned char *>(str), base_uri.c_obj(), model.c_obj()) == 0;
     }
@@ -1376,6 +3261,13 @@ public:
 
     bool parse_into_model(const char *str, size_t length, const Uri &base_uri, const Model &model)
     {
+        if (model.model_reports())
+            return parse_reported(model, base_uri, [&](raptor_parser *parser, raptor_uri *base)
+                {
+                    if (raptor_parser_parse_start(parser, base) != 0)
+                        return 1;
+                    return raptor_parser_parse_chunk(parser, reinterpret_cast<const unsigned char *>(str), length, 1);
+                });
         return librdf_parser_parse_counted_string_into_model(
             c_obj_, reinterpret_cast<const unsigned char *>(str), length, base_uri.c_obj(), model.c_obj()) == 0;
     }
@@ -1401,6 +3293,11 @@ public:
 
     bool parse_into_model(raptor_iostream *iostr, const Uri &base_uri, const Model &model)
     {
+        if (model.model_reports())
+            return parse_reported(model, base_uri, [&](raptor_parser *parser, raptor_uri *base)
+                {
+                    return raptor_parser_parse_iostream(parser, iostr, base);
+                });
         return librdf_parser_parse_iostream_into_model(c_obj_, iostr, base_uri.c_obj(), model.c_obj()) == 0;
     }
 
@@ -1427,31 +3324,314 @@ public:
     {
         return librdf_parser_set_feature(c_obj_, feature.c_obj(), value.c_obj()) == 0;
     }
+
+    // Push mode parsing
+
+    /**
+     * Set handler receiving every statement as soon as the parser completed it.
+     * The statement is only valid during the call.
+     */
+    void set_statement_handler(StatementHandler handler)
+    {
+        statement_handler_ = std::move(handler);
+    }
+
+    /**
+     * Start incremental parsing, input is then passed in chunks with feed()
+     * and terminated with finish(). Requires parser created from a World.
+     */
+    bool begin(const Uri &base_uri)
+    {
+        if (!world_)
+            return false;
+        raptor_world *rw = librdf_world_get_raptor(world_->c_obj());
+        if (!rw)
+            return false;
+
+        if (!push_parser_)
+        {
+            const char *name = raptor_name(rw);
+            if (!name)
+                return false;
+            push_parser_ = raptor_new_parser(rw, name);
+            if (!push_parser_)
+                throw AllocException("raptor_new_parser");
+            raptor_parser_set_statement_handler(push_parser_, this, &Parser::handle_raptor_statement);
+        }
+
+        push_failed_ = false;
+        raptor_uri *base = 0;
+        if (base_uri.is_valid())
+            base = raptor_new_uri(rw, librdf_uri_as_string(base_uri.c_obj()));
+        const bool result = raptor_parser_parse_start(push_parser_, base) == 0;
+        if (base)
+            raptor_free_uri(base);
+        return result;
+    }
+
+    bool begin(const char *base_uri)
+    {
+        return world_ && begin(base_uri ? Uri(*world_, base_uri) : Uri());
+    }
+
+    bool feed(const char *data, size_t length)
+    {
+        if (!push_parser_)
+            return false;
+        const int result = raptor_parser_parse_chunk(
+            push_parser_, reinterpret_cast<const unsigned char *>(data), length, 0);
+        return result == 0 && !push_failed_;
+    }
+
+    bool finish()
+    {
+        if (!push_parser_)
+            return false;
+        const int result = raptor_parser_parse_chunk(push_parser_, 0, 0, 1);
+        return result == 0 && !push_failed_;
+    }
+
+private:
+
+    /** raptor name of the syntax, 0 when it is unknown */
+    const char * raptor_name(raptor_world *rw) const
+    {
+        if (!name_.empty())
+            return name_.c_str();
+        return raptor_world_guess_parser_name(rw, 0, mime_type_.empty() ? 0 : mime_type_.c_str(), 0, 0, 0);
+    }
+
+    static raptor_uri * new_raptor_uri(const Model &model, const Uri &uri)
+    {
+        raptor_world *rw = librdf_world_get_raptor(model.get_world().c_obj());
+        return rw && uri.is_valid() ? raptor_new_uri(rw, librdf_uri_as_string(uri.c_obj())) : 0;
+    }
+
+    /** Model receiving the statements of parse_reported */
+    struct ReportedParse
+    {
+        const World *world;
+        Model *model;
+        raptor_parser *parser;
+        bool contexts;
+        bool failed;
+    };
+
+    /**
+     * librdf adds parsed statements to the storage directly, past the
+     * Model. A model reporting to its listeners is therefore parsed with a
+     * raptor parser of the same syntax, which adds every statement through
+     * the Model as soon as it is parsed. Graphs of N-Quads and TriG input
+     * become contexts when the model supports them. parse runs the raptor
+     * parser and returns 0 on success.
+     */
+    template <class Parse>
+    bool parse_reported(const Model &model, const Uri &base_uri, Parse parse)
+    {
+        const World &world = model.get_world();
+        raptor_world *rw = librdf_world_get_raptor(world.c_obj());
+        const char *name = rw ? raptor_name(rw) : 0;
+        if (!name)
+            return false;
+        raptor_parser *parser = raptor_new_parser(rw, name);
+        if (!parser)
+            throw AllocException("raptor_new_parser");
+        ReportedParse target = { &world, &const_cast<Model &>(model), parser, model.supports_contexts(), false };
+        raptor_parser_set_statement_handler(parser, &target, &Parser::handle_reported_statement);
+
+        raptor_uri *base = new_raptor_uri(model, base_uri);
+        const bool result = parse(parser, base) == 0;
+        if (base)
+            raptor_free_uri(base);
+        raptor_free_parser(parser);
+        return result && !target.failed;
+    }
+
+    static void handle_reported_statement(void *user_data, raptor_statement *rstatement)
+    {
+        ReportedParse *target = static_cast<ReportedParse *>(user_data);
+        if (target->failed)
+            return;
+        // exceptions must not propagate through raptor's C frames
+        try
+        {
+            const World &world = *target->world;
+            Statement statement(world,
+                Node::make_from_raptor_term(world, rstatement->subject),
+                Node::make_from_raptor_term(world, rstatement->predicate),
+                Node::make_from_raptor_term(world, rstatement->object));
+            const bool added = target->contexts && rstatement->graph ?
+                target->model->add_statement(Node::make_from_raptor_term(world, rstatement->graph), statement) :
+                target->model->add_statement(statement);
+            if (added)
+                return;
+        }
+        catch (...)
+        {
+        }
+        target->failed = true;
+        raptor_parser_parse_abort(target->parser);
+    }
+
+    static void handle_raptor_statement(void *user_data, raptor_statement *rstatement)
+    {
+        Parser *parser = static_cast<Parser *>(user_data);
+        if (!parser->statement_handler_ || parser->push_failed_)
+            return;
+        // exceptions must not propagate through raptor's C frames
+        try
+        {
+            const World &world = *parser->world_;
+            Statement statement(world,
+                Node::make_from_raptor_term(world, rstatement->subject),
+                Node::make_from_raptor_term(world, rstatement->predicate),
+                Node::make_from_raptor_term(world, rstatement->object));
+            parser->statement_handler_(statement);
+        }
+        catch (...)
+        {
+            parser->push_failed_ = true;
+            raptor_parser_parse_abort(parser->push_parser_);
+        }
+    }
+
+    const World *world_;
+    std::string name_;
+    std::string mime_type_;
+    raptor_parser *push_parser_;
+    bool push_failed_;
+    StatementHandler statement_handler_;
+};
+
+/**
+ * Parsers and serializers of a World, keyed by format name and for
+ * serializers also by the registered namespaces.
+ */
+struct FormatCache
+{
+    /** Cached entries per kind, the least recently used one is evicted */
+    enum { max_entries = 32 };
+
+    template <class T>
+    class Entries
+    {
+    public:
+
+        std::shared_ptr<T> find(const std::string &key)
+        {
+            typename Index::iterator it = index_.find(key);
+            if (it == index_.end())
+                return std::shared_ptr<T>();
+            // most recently used first
+            recent_.splice(recent_.begin(), recent_, it->second);
+            return it->second->second;
+        }
+
+        void insert(const std::string &key, const std::shared_ptr<T> &value)
+        {
+            if (index_.size() >= max_entries)
+            {
+                index_.erase(recent_.back().first);
+                recent_.pop_back();
+            }
+            recent_.push_front(std::make_pair(key, value));
+            index_.insert(std::make_pair(key, recent_.begin()));
+        }
+
+    private:
+        typedef std::list<std::pair<std::string, std::shared_ptr<T> > > Recent;
+        typedef std::unordered_map<std::string, typename Recent::iterator> Index;
+
+        Recent recent_;
+        Index index_;
+    };
+
+    Entries<Parser> parsers;
+    Entries<Serializer> serializers;
 };
 
+inline World & World::operator=(World && other)
+{
+    format_cache_ = std::move(other.format_cache_);
+    return static_cast<World&>(CObjWrapper::operator=(std::move(other)));
+}
+
+inline World::~World()
+{
+    // parsers and serializers must be freed before their world
+    format_cache_.reset();
+    librdf_free_world(c_obj_);
+}
+
+inline std::shared_ptr<Parser> World::cached_parser(const char *format_name) const
+{
+    if (!format_cache_)
+        format_cache_.reset(new FormatCache());
+
+    const std::string key(format_name ? format_name : "");
+    std::shared_ptr<Parser> cached = format_cache_->parsers.find(key);
+    if (cached)
+        return cached;
+
+    librdf_parser *parser = librdf_new_parser(c_obj_, format_name, NULL, NULL);
+    if (!parser)
+        return cached;
+    cached = std::make_shared<Parser>(parser);
+    format_cache_->parsers.insert(key, cached);
+    return cached;
+}
+
+inline std::shared_ptr<Serializer> World::cached_serializer(const char *format_name, const Namespaces &namespaces) const
+{
+    if (!format_cache_)
+        format_cache_.reset(new FormatCache());
+
+    std::string key(format_name ? format_name : "");
+    const std::map<std::string, std::string> &prefixes = namespaces.prefix_map();
+    for (std::map<std::string, std::string>::const_iterator it = prefixes.begin(); it != prefixes.end(); ++it)
+    {
+        key += '\n';
+        key += it->first;
+        key += '=';
+        key += it->second;
+    }
+
+    std::shared_ptr<Serializer> cached = format_cache_->serializers.find(key);
+    if (cached)
+        return cached;
+
+    librdf_serializer *serializer = librdf_new_serializer(c_obj_, format_name, NULL, NULL);
+    if (!serializer)
+        return cached;
+    cached = std::make_shared<Serializer>(serializer);
+    namespaces.register_with_serializer(*this, serializer);
+    format_cache_->serializers.insert(key, cached);
+    return cached;
+}
+
+inline void World::clear_format_cache() const
+{
+    format_cache_.reset();
+}
+
 inline bool serialize_rdf(FILE *fd, const World &world, const Model &model, Namespaces &namespaces, const char *format_name = "turtle")
 {
-    librdf_serializer *ser = librdf_new_serializer(world.c_obj(), format_name, NULL, NULL);
+    const std::shared_ptr<Serializer> ser = world.cached_serializer(format_name, namespaces);
 
     if (!ser)
     {
-        std::string errmsg = std::string("Could not load ")+(format_name ? format_name : "<empty>")+" serializer";
-        fprintf(stderr, errmsg.c_str());
+        fprintf(stderr, "Could not load %s serializer\n", format_name ? format_name : "<empty>");
         return false;
     }
 
-    namespaces.register_with_serializer(world, ser);
-
-    int result = librdf_serializer_serialize_model_to_file_handle(ser, fd, NULL, model.c_obj());
-
-    librdf_free_serializer(ser);
-
-    return result == 0;
+    return ser->serialize_model(fd, model);
 }
 
 inline bool serialize_rdf(const char *filename, const World &world, const Model &model, Namespaces &namespaces, const char *format_name = "turtle")
 {
     FILE *fd = fopen(filename, "wb");
+    if (!fd)
+        return false;
 
     bool result = serialize_rdf(fd, world, model, namespaces, format_name);
 
@@ -1462,29 +3642,15 @@ inline bool serialize_rdf(const char *filename, const World &world, const Model
 
 inline bool serialize_rdf_to_string(std::string &dest, const World &world, const Model &model, Namespaces &namespaces, const char *format_name = "turtle")
 {
-    librdf_serializer *ser = librdf_new_serializer(world.c_obj(), format_name, NULL, NULL);
-
-    namespaces.register_with_serializer(world, ser);
+    const std::shared_ptr<Serializer> ser = world.cached_serializer(format_name, namespaces);
 
     if (!ser)
     {
-        std::string errmsg = std::string("Could not load ")+(format_name ? format_name : "<empty>")+" serializer";
-        fprintf(stderr, errmsg.c_str());
-        return false;
-    }
-
-    unsigned char *str = librdf_serializer_serialize_model_to_string(ser, NULL, model.c_obj());
-    if (!str)
-    {
-        librdf_free_serializer(ser);
+        fprintf(stderr, "Could not load %s serializer\n", format_name ? format_name : "<empty>");
         return false;
     }
-    dest.assign(reinterpret_cast<char*>(str));
 
-    librdf_free_memory(str);
-    librdf_free_serializer(ser);
-
-    return true;
+    return ser->serialize_model(dest, model);
 }
 
 inline bool serialize_turtle(const char *filename, const World &world, const Model &model, Namespaces &namespaces)
@@ -1494,30 +3660,18 @@ inline bool serialize_turtle(const char *filename, const World &world, const Mod
 
 inline bool parse_rdf(const char *filename, const char *base_uri, const World &world, const Model &model, const char *format_name = "turtle")
 {
-    librdf_parser *par = librdf_new_parser(world.c_obj(), "turtle", NULL, NULL);
+    const std::shared_ptr<Parser> par = world.cached_parser(format_name);
 
     if (!par)
     {
-        fprintf(stderr, "Could not load turtle parser");
+        fprintf(stderr, "Could not load %s parser\n", format_name ? format_name : "<empty>");
         return false;
     }
     FILE *fd = fopen(filename, "rb");
+    if (!fd)
+        return false;
 
-    int result;
-
-    if (base_uri)
-    {
-        Uri uri(world, base_uri);
-        result = librdf_parser_parse_file_handle_into_model(par, fd, 1, uri.c_obj(), model.c_obj());
-    }
-    else
-    {
-        result = librdf_parser_parse_file_handle_into_model(par, fd, 1, NULL, model.c_obj());
-    }
-
-    librdf_free_parser(par);
-
-    return result == 0;
+    return par->parse_into_model(fd, true, base_uri ? Uri(world, base_uri) : Uri(), model);
 }
 
 inline bool parse_turtle(const char *filename, const char *base_uri, const World &world, const Model &model)
@@ -1527,29 +3681,15 @@ inline bool parse_turtle(const char *filename, const char *base_uri, const World
 
 inline bool parse_rdf_from_string(const char *str, const char *base_uri, const World &world, const Model &model, const char *format_name = "turtle")
 {
-    librdf_parser *par = librdf_new_parser(world.c_obj(), "turtle", NULL, NULL);
+    const std::shared_ptr<Parser> par = world.cached_parser(format_name);
 
     if (!par)
     {
-        fprintf(stderr, "Could not load turtle parser");
+        fprintf(stderr, "Could not load %s parser\n", format_name ? format_name : "<empty>");
         return false;
     }
 
-    int result;
-
-    if (base_uri)
-    {
-        Uri uri(world, base_uri);
-        result = librdf_parser_parse_string_into_model(par, (const unsigned char *)str, uri.c_obj(), model.c_obj());
-    }
-    else
-    {
-        result = librdf_parser_parse_string_into_model(par, (const unsigned char *)str, NULL, model.c_obj());
-    }
-
-    librdf_free_parser(par);
-
-    return result == 0;
+    return par->parse_into_model(str, base_uri ? Uri(world, base_uri) : Uri(), model);
 }
 
 inline bool parse_turtle_from_string(const char *str, const char *base_uri, const World &world, const Model &model)
@@ -1557,32 +3697,88 @@ inline bool parse_turtle_from_string(const char *str, const char *base_uri, cons
     return parse_rdf_from_string(str, base_uri, world, model, "turtle");
 }
 
+namespace Detail
+{
+
 /**
- * Computes fix point of all blank nodes reachable from passed node
+ * Stream the statements reachable from node through blank objects to
+ * first. visit(node) returns false for nodes already visited.
  */
-template <class OutputIt>
-OutputIt add_reachable_blank_nodes(OutputIt first, const Redland::Node &node, std::unordered_set<std::string> &added_names, const Redland::Model &model)
+template <class OutputIt, class Visit>
+OutputIt add_reachable_blank_nodes(OutputIt first, const Redland::Node &node, Visit visit, const Redland::Model &model)
 {
-    std::string nid =
-        node.is_blank() ? ("b:" + node.get_blank_identifier()) :
-        (node.is_literal() ? ("l:" + node.get_literal_value()) : ("u:" + node.get_uri_as_string()));
-    if (added_names.find(nid) != added_names.end())
+    if (!node.is_valid() || !visit(node))
         return first;
-    added_names.insert(nid);
 
-    Redland::Statement stmt(model.get_world(), node, Redland::Node(), Redland::Node());
-    auto stmtsResult = model.find_statements(stmt);
-    for (auto it = std::begin(stmtsResult), et = std::end(stmtsResult); it != et; ++it)
+    const World &world = model.get_world();
+    std::vector<Node> worklist;
+    worklist.push_back(node);
+
+    while (!worklist.empty())
     {
-        auto object = (*it).get_object();
-        *first++ = std::move(*it);
+        Statement pattern(world, std::move(worklist.back()), Node(), Node());
+        worklist.pop_back();
 
-        if (object.is_blank())
-            first = add_reachable_blank_nodes(first, object, added_names, model);
+        librdf_stream *sr = librdf_model_find_statements(model.c_obj(), pattern.c_obj());
+        if (!sr)
+            continue;
+        Stream stream(sr);
+        for (; !stream.is_end(); stream.next())
+        {
+            librdf_statement *stmt = librdf_stream_get_object(stream.c_obj());
+            if (!stmt)
+                continue;
+            librdf_node *object = librdf_statement_get_object(stmt);
+            if (object && librdf_node_is_blank(object))
+            {
+                Node object_node(librdf_new_node_from_node(object));
+                if (visit(object_node))
+                    worklist.push_back(std::move(object_node));
+            }
+            *first++ = Statement(librdf_new_statement_from_statement(stmt));
+        }
     }
     return first;
 }
 
+} // namespace Detail
+
+/**
+ * Computes fix point of all blank nodes reachable from passed node.
+ * Iterative, visited nodes are kept in the passed set, matching statements
+ * are streamed to the output without intermediate containers.
+ *
+ * All statements of a subject are output together, but the subjects come
+ * in last in first out order of a worklist: the statements of a blank
+ * object may follow statements of later objects of the same subject,
+ * while the former recursive version output them right after the
+ * statement referencing the blank node.
+ */
+template <class OutputIt>
+OutputIt add_reachable_blank_nodes(OutputIt first, const Redland::Node &node, NodeSet &visited, const Redland::Model &model)
+{
+    return Detail::add_reachable_blank_nodes(first, node,
+        [&visited](const Node &n) { return visited.insert(n).second; }, model);
+}
+
+/**
+ * Same as above with visited nodes named by their kind and value, "b:" and
+ * the blank identifier, "l:" and the literal value or "u:" and the URI.
+ * Kept for existing callers, NodeSet avoids building the names.
+ */
+template <class OutputIt>
+OutputIt add_reachable_blank_nodes(OutputIt first, const Redland::Node &node,
+                                   std::unordered_set<std::string> &added_names, const Redland::Model &model)
+{
+    return Detail::add_reachable_blank_nodes(first, node, [&added_names](const Node &n)
+        {
+            const std::string name =
+                n.is_blank() ? ("b:" + n.get_blank_identifier()) :
+                (n.is_literal() ? ("l:" + n.get_literal_value()) : ("u:" + n.get_uri_as_string()));
+            return added_names.insert(name).second;
+        }, model);
+}
+
 /**
  * Compute directly reachable statements from passed node,
  * including statements containing intermediate blank nodes.
@@ -1591,14 +3787,120 @@ template <class Container>
 Container get_reachable_statements(const Redland::Node &node, const Redland::Model &model)
 {
     Container result;
-    std::unordered_set<std::string> added_names;
-    add_reachable_blank_nodes(std::back_insert_iterator<Container>(result), node, added_names, model);
+    NodeSet visited;
+    add_reachable_blank_nodes(std::back_insert_iterator<Container>(result), node, visited, model);
+    return result;
+}
+
+/**
+ * Compute reachable statements for many root nodes at once. The model is
+ * scanned once to build a subject index, then the closure of every root
+ * is computed from the index, with num_threads worker threads.
+ * Result contains one container per root, in the order of roots.
+ */
+template <class Container>
+std::vector<Container> get_reachable_statements_batch(const std::vector<Redland::Node> &roots,
+                                                      const Redland::Model &model,
+                                                      unsigned num_threads = 1)
+{
+    typedef std::unordered_map<librdf_node *, std::vector<std::size_t>, NodeHash, NodeEqual> SubjectIndex;
+
+    std::vector<Statement> statements;
+    SubjectIndex index;
+    {
+        Stream stream(model.as_stream());
+        for (; stream.is_valid() && !stream.is_end(); stream.next())
+        {
+            librdf_statement *stmt = librdf_stream_get_object(stream.c_obj());
+            if (!stmt)
+                continue;
+            statements.push_back(Statement(librdf_new_statement_from_statement(stmt)));
+            index[librdf_statement_get_subject(statements.back().c_obj())].push_back(statements.size() - 1);
+        }
+    }
+
+    // Closures only read the index, librdf objects are not copied or freed here
+    std::vector<std::vector<std::size_t> > closures(roots.size());
+    auto compute = [&](std::size_t first_root, std::size_t step)
+    {
+        std::unordered_set<librdf_node *, NodeHash, NodeEqual> visited;
+        std::vector<librdf_node *> worklist;
+        for (std::size_t r = first_root; r < roots.size(); r += step)
+        {
+            std::vector<std::size_t> &closure = closures[r];
+            visited.clear();
+            if (!roots[r].is_valid())
+                continue;
+            worklist.push_back(roots[r].c_obj());
+            visited.insert(roots[r].c_obj());
+            while (!worklist.empty())
+            {
+                librdf_node *subject = worklist.back();
+                worklist.pop_back();
+                SubjectIndex::const_iterator it = index.find(subject);
+                if (it == index.end())
+                    continue;
+                for (std::vector<std::size_t>::const_iterator si = it->second.begin(); si != it->second.end(); ++si)
+                {
+                    closure.push_back(*si);
+                    librdf_node *object = librdf_statement_get_object(statements[*si].c_obj());
+                    if (object && librdf_node_is_blank(object) && visited.insert(object).second)
+                        worklist.push_back(object);
+                }
+            }
+        }
+    };
+
+    if (num_threads <= 1 || roots.size() < 2)
+    {
+        compute(0, 1);
+    }
+    else
+    {
+        const std::size_t step = std::min<std::size_t>(num_threads, roots.size());
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < step; ++t)
+            threads.push_back(std::thread(compute, t, step));
+        for (std::size_t t = 0; t < threads.size(); ++t)
+            threads[t].join();
+    }
+
+    std::vector<Container> result(roots.size());
+    for (std::size_t r = 0; r < roots.size(); ++r)
+    {
+        std::back_insert_iterator<Container> out(result[r]);
+        for (std::vector<std::size_t>::const_iterator it = closures[r].begin(); it != closures[r].end(); ++it)
+            *out++ = statements[*it];
+    }
     return result;
 }
 
 
 } // namespace Redland
 
+namespace std
+{
+
+template <>
+struct hash<Redland::Node>
+{
+    std::size_t operator()(const Redland::Node &node) const
+    {
+        return node.hash();
+    }
+};
+
+template <>
+struct hash<Redland::Statement>
+{
+    std::size_t operator()(const Redland::Statement &statement) const
+    {
+        return statement.hash();
+    }
+};
+
+} // namespace std
+
 namespace Raptor
 {
 
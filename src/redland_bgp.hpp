@@ -0,0 +1,530 @@
+/*
+ * redland_bgp.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_BGP_HPP_INCLUDED
+#define RDW_BGP_HPP_INCLUDED
+
+#include "redland.hpp"
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Basic graph pattern: a set of triple patterns with variables, matched
+ * against a Model.
+ *
+ *     BasicGraphPattern bgp;
+ *     BasicGraphPattern::Variable pose = bgp.variable("pose"), r = bgp.variable("r"),
+ *         q = bgp.variable("q"), x = bgp.variable("x");
+ *     bgp.add(pose, rotation, r);
+ *     bgp.add(r, quantity_value, q);
+ *     bgp.add(q, maths_x, x);
+ *     bgp.filter(x, [](NodeView v) { return std::strtod(v.literal_value().data(), 0) > 0.5; });
+ *     bgp.execute(model, [&](const BasicGraphPattern::Solution &s) { ...; return true; });
+ *
+ * Patterns are ordered by the number of matches of their constant part,
+ * probed up to probe_limit statements, preferring patterns connected to
+ * already bound variables. A pattern with two bound positions is joined
+ * by an index lookup (librdf_model_get_sources, _get_arcs, _get_targets),
+ * one with three bound positions by a containment check. A pattern with
+ * fewer bound positions is hashed on the join variables and probed (hash
+ * join) when its constant part matched fewer than probe_limit statements.
+ * Otherwise, e.g. for ?s ?p ?o with only ?s bound, copying its extent
+ * would copy most of the model, so the statements are found with the
+ * bound values for every binding instead. Solutions are streamed to the
+ * caller and refer to nodes owned by the model, valid during the callback
+ * only.
+ */
+class BasicGraphPattern
+{
+public:
+
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /** How a pattern is joined, see plan */
+    enum Method
+    {
+        /** All positions bound, check that the statement exists */
+        CONTAINS,
+        /** Two positions bound, iterate the nodes of the third */
+        LOOKUP,
+        /** Hash the statements of the constant part once, probe per binding */
+        HASH_JOIN,
+        /** Find the statements matching constants and bound values */
+        SCAN
+    };
+
+    struct Variable
+    {
+        std::size_t index;
+    };
+
+    /** Pattern position, a constant node or a variable */
+    class Term
+    {
+    public:
+
+        Term(const Node &node)
+            : node_(node)
+            , variable_(npos)
+        { }
+
+        Term(Variable variable)
+            : variable_(variable.index)
+        { }
+
+        bool is_variable() const { return variable_ != npos; }
+
+        std::size_t variable() const { return variable_; }
+
+        const Node & node() const { return node_; }
+
+    private:
+        Node node_;
+        std::size_t variable_;
+    };
+
+    /** Values of all variables for one match */
+    class Solution
+    {
+    public:
+
+        std::size_t size() const { return values_.size(); }
+
+        NodeView operator[](Variable variable) const { return values_[variable.index]; }
+
+        NodeView operator[](std::size_t index) const { return values_[index]; }
+
+        /** Owning copy of a value, for keeping it after the callback */
+        Node node(Variable variable) const
+        {
+            return NodeView(values_[variable.index]).to_node();
+        }
+
+    private:
+        friend class BasicGraphPattern;
+
+        explicit Solution(const std::vector<librdf_node *> &values)
+            : values_(values)
+        { }
+
+        const std::vector<librdf_node *> &values_;
+    };
+
+    typedef std::function<bool (NodeView)> Filter;
+
+    explicit BasicGraphPattern(std::size_t probe_limit = 1024)
+        : probe_limit_(probe_limit)
+    { }
+
+    /** Variable of name, created on first use */
+    Variable variable(const std::string &name)
+    {
+        Variable result;
+        for (result.index = 0; result.index < names_.size(); ++result.index)
+        {
+            if (names_[result.index] == name)
+                return result;
+        }
+        names_.push_back(name);
+        filters_.push_back(std::vector<Filter>());
+        return result;
+    }
+
+    std::size_t num_variables() const { return names_.size(); }
+
+    const std::string & variable_name(std::size_t index) const { return names_[index]; }
+
+    std::size_t num_patterns() const { return patterns_.size(); }
+
+    void add(const Term &subject, const Term &predicate, const Term &object)
+    {
+        Pattern pattern = { { subject, predicate, object } };
+        patterns_.push_back(pattern);
+    }
+
+    /**
+     * Only accept values of variable for which filter returns true. Filters
+     * run as soon as the variable is bound, pruning the join early.
+     */
+    void filter(Variable variable, Filter filter)
+    {
+        filters_[variable.index].push_back(filter);
+    }
+
+    /**
+     * Pattern indexes in the order execute would join them, methods is set
+     * to the method of each step when not null.
+     */
+    std::vector<std::size_t> plan(const Model &model, std::vector<Method> *methods = 0) const
+    {
+        std::vector<Step> steps(make_plan(model));
+        std::vector<std::size_t> order;
+        if (methods)
+            methods->clear();
+        for (std::vector<Step>::const_iterator it = steps.begin(); it != steps.end(); ++it)
+        {
+            order.push_back(it->pattern);
+            if (methods)
+                methods->push_back(it->method);
+        }
+        return order;
+    }
+
+    /**
+     * Call function for every solution until it returns false, returns the
+     * number of solutions passed to function.
+     */
+    template <class Function>
+    std::size_t execute(const Model &model, Function function) const
+    {
+        State state(model, make_plan(model), function, names_.size());
+        run(state, 0);
+        return state.count;
+    }
+
+    /** All solutions, up to limit when limit is not 0 */
+    std::vector<std::vector<Node> > select(const Model &model, std::size_t limit = 0) const
+    {
+        std::vector<std::vector<Node> > rows;
+        execute(model, [&](const Solution &solution) -> bool
+            {
+                std::vector<Node> row;
+                row.reserve(solution.size());
+                for (std::size_t i = 0; i < solution.size(); ++i)
+                    row.push_back(solution[i].to_node());
+                rows.push_back(std::move(row));
+                return !limit || rows.size() < limit;
+            });
+        return rows;
+    }
+
+private:
+
+    struct Pattern
+    {
+        Term terms[3];
+    };
+
+    struct Step
+    {
+        std::size_t pattern;
+        Method method;
+        /** Unbound position for LOOKUP */
+        int free_position;
+        /** Positions bound by earlier steps for HASH_JOIN */
+        std::vector<int> join_positions;
+    };
+
+    /** Statements of a pattern's constant part, hashed on the join positions */
+    struct HashTable
+    {
+        bool built;
+        std::vector<Node> rows;
+        std::unordered_map<std::size_t, std::vector<std::size_t> > buckets;
+
+        HashTable() : built(false) { }
+    };
+
+    struct State
+    {
+        const Model &model;
+        std::vector<Step> steps;
+        std::function<bool (const Solution &)> function;
+        std::vector<librdf_node *> values;
+        std::vector<HashTable> tables;
+        std::size_t count;
+        bool stopped;
+
+        State(const Model &model, const std::vector<Step> &steps,
+              const std::function<bool (const Solution &)> &function, std::size_t num_variables)
+            : model(model)
+            , steps(steps)
+            , function(function)
+            , values(num_variables, static_cast<librdf_node *>(0))
+            , tables(steps.size())
+            , count(0)
+            , stopped(false)
+        { }
+    };
+
+    /** Statements matching the constant part of pattern, up to probe_limit_ */
+    std::size_t estimate(const Model &model, const Pattern &pattern) const
+    {
+        librdf_node *nodes[3];
+        for (int i = 0; i < 3; ++i)
+            nodes[i] = pattern.terms[i].is_variable() ? 0 : pattern.terms[i].node().c_obj();
+        const StatementRef statement(model.get_world(), nodes[0], nodes[1], nodes[2]);
+        Stream stream(librdf_model_find_statements(model.c_obj(), statement.c_obj()));
+        std::size_t count = 0;
+        for (; stream.is_valid() && !stream.is_end() && count < probe_limit_; stream.next())
+            count++;
+        return count;
+    }
+
+    std::vector<Step> make_plan(const Model &model) const
+    {
+        std::vector<std::size_t> estimates;
+        for (std::vector<Pattern>::const_iterator it = patterns_.begin(); it != patterns_.end(); ++it)
+            estimates.push_back(estimate(model, *it));
+
+        std::vector<char> used(patterns_.size(), 0);
+        std::vector<char> bound(names_.size(), 0);
+        std::vector<Step> steps;
+        for (std::size_t n = 0; n < patterns_.size(); ++n)
+        {
+            std::size_t best = npos;
+            int best_connected = 0, best_bound = 0;
+            for (std::size_t p = 0; p < patterns_.size(); ++p)
+            {
+                if (used[p])
+                    continue;
+                int num_bound = 0, connected = n == 0;
+                for (int i = 0; i < 3; ++i)
+                {
+                    const Term &term = patterns_[p].terms[i];
+                    if (!term.is_variable())
+                        num_bound++;
+                    else if (bound[term.variable()])
+                    {
+                        num_bound++;
+                        connected = 1;
+                    }
+                }
+                if (best == npos || connected > best_connected
+                    || (connected == best_connected && (num_bound > best_bound
+                        || (num_bound == best_bound && estimates[p] < estimates[best]))))
+                {
+                    best = p;
+                    best_connected = connected;
+                    best_bound = num_bound;
+                }
+            }
+
+            Step step;
+            step.pattern = best;
+            step.free_position = -1;
+            const Pattern &pattern = patterns_[best];
+            for (int i = 0; i < 3; ++i)
+            {
+                const Term &term = pattern.terms[i];
+                if (!term.is_variable())
+                    continue;
+                if (bound[term.variable()])
+                    step.join_positions.push_back(i);
+                else
+                    step.free_position = i;
+            }
+            if (best_bound == 3)
+                step.method = CONTAINS;
+            else if (best_bound == 2)
+                step.method = LOOKUP;
+            else if (!step.join_positions.empty() && estimates[best] < probe_limit_)
+                step.method = HASH_JOIN;
+            else
+                step.method = SCAN;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                if (pattern.terms[i].is_variable())
+                    bound[pattern.terms[i].variable()] = 1;
+            }
+            used[best] = 1;
+            steps.push_back(step);
+        }
+        return steps;
+    }
+
+    bool accept(std::size_t variable, librdf_node *node) const
+    {
+        const std::vector<Filter> &filters = filters_[variable];
+        for (std::vector<Filter>::const_iterator it = filters.begin(); it != filters.end(); ++it)
+        {
+            if (!(*it)(NodeView(node)))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Bind the variables of pattern to the matched nodes. Returns the number
+     * of newly bound variables stored in bound, or -1 on a conflict.
+     */
+    int bind(State &state, const Pattern &pattern, librdf_node *const nodes[3], std::size_t bound[3]) const
+    {
+        int num_bound = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (!pattern.terms[i].is_variable())
+                continue;
+            const std::size_t variable = pattern.terms[i].variable();
+            librdf_node *&value = state.values[variable];
+            if (value ? !NodeEqual()(value, nodes[i]) : !accept(variable, nodes[i]))
+            {
+                unbind(state, bound, num_bound);
+                return -1;
+            }
+            if (!value)
+            {
+                value = nodes[i];
+                bound[num_bound++] = variable;
+            }
+        }
+        return num_bound;
+    }
+
+    static void unbind(State &state, const std::size_t bound[3], int num_bound)
+    {
+        for (int i = 0; i < num_bound; ++i)
+            state.values[bound[i]] = 0;
+    }
+
+    void match(State &state, std::size_t step, const Pattern &pattern, librdf_node *const nodes[3]) const
+    {
+        std::size_t bound[3];
+        const int num_bound = bind(state, pattern, nodes, bound);
+        if (num_bound < 0)
+            return;
+        run(state, step + 1);
+        unbind(state, bound, num_bound);
+    }
+
+    static std::size_t join_hash(librdf_node *const nodes[3], const std::vector<int> &positions)
+    {
+        NodeHash node_hash;
+        std::size_t h = 0;
+        for (std::vector<int>::const_iterator it = positions.begin(); it != positions.end(); ++it)
+            h = h * 31 + node_hash(nodes[*it]);
+        return h;
+    }
+
+    void build_table(State &state, std::size_t i, const Pattern &pattern) const
+    {
+        const Step &step = state.steps[i];
+        HashTable &table = state.tables[i];
+        librdf_node *nodes[3];
+        for (int i = 0; i < 3; ++i)
+            nodes[i] = pattern.terms[i].is_variable() ? 0 : pattern.terms[i].node().c_obj();
+        const StatementRef statement(state.model.get_world(), nodes[0], nodes[1], nodes[2]);
+        Stream stream(librdf_model_find_statements(state.model.c_obj(), statement.c_obj()));
+        for (; stream.is_valid() && !stream.is_end(); stream.next())
+        {
+            librdf_statement *st = librdf_stream_get_object(stream.c_obj());
+            if (!st)
+                continue;
+            librdf_node *parts[3] = {
+                librdf_statement_get_subject(st),
+                librdf_statement_get_predicate(st),
+                librdf_statement_get_object(st)
+            };
+            const std::size_t row = table.rows.size() / 3;
+            for (int i = 0; i < 3; ++i)
+                table.rows.push_back(Node(librdf_new_node_from_node(parts[i])));
+            table.buckets[join_hash(parts, step.join_positions)].push_back(row);
+        }
+        table.built = true;
+    }
+
+    void run(State &state, std::size_t i) const
+    {
+        if (state.stopped)
+            return;
+        if (i == state.steps.size())
+        {
+            state.count++;
+            if (!state.function(Solution(state.values)))
+                state.stopped = true;
+            return;
+        }
+
+        const Step &step = state.steps[i];
+        const Pattern &pattern = patterns_[step.pattern];
+        librdf_node *nodes[3];
+        for (int p = 0; p < 3; ++p)
+        {
+            const Term &term = pattern.terms[p];
+            nodes[p] = term.is_variable() ? state.values[term.variable()] : term.node().c_obj();
+        }
+        const World &world = state.model.get_world();
+        librdf_model *model = state.model.c_obj();
+
+        switch (step.method)
+        {
+            case CONTAINS:
+            {
+                if (state.model.has_statement(StatementRef(world, nodes[0], nodes[1], nodes[2])))
+                    run(state, i + 1);
+                break;
+            }
+            case LOOKUP:
+            {
+                const int free = step.free_position;
+                Iterator iterator(free == 0 ? librdf_model_get_sources(model, nodes[1], nodes[2])
+                    : free == 1 ? librdf_model_get_arcs(model, nodes[0], nodes[2])
+                    : librdf_model_get_targets(model, nodes[0], nodes[1]));
+                for (; iterator.is_valid() && !iterator.is_end() && !state.stopped; iterator.next())
+                {
+                    nodes[free] = static_cast<librdf_node *>(iterator.get_object());
+                    if (nodes[free])
+                        match(state, i, pattern, nodes);
+                }
+                break;
+            }
+            case SCAN:
+            {
+                const StatementRef statement(world, nodes[0], nodes[1], nodes[2]);
+                Stream stream(librdf_model_find_statements(model, statement.c_obj()));
+                for (; stream.is_valid() && !stream.is_end() && !state.stopped; stream.next())
+                {
+                    if (librdf_statement *st = librdf_stream_get_object(stream.c_obj()))
+                    {
+                        librdf_node *parts[3] = {
+                            librdf_statement_get_subject(st),
+                            librdf_statement_get_predicate(st),
+                            librdf_statement_get_object(st)
+                        };
+                        match(state, i, pattern, parts);
+                    }
+                }
+                break;
+            }
+            case HASH_JOIN:
+            {
+                HashTable &table = state.tables[i];
+                if (!table.built)
+                    build_table(state, i, pattern);
+                std::unordered_map<std::size_t, std::vector<std::size_t> >::const_iterator bucket =
+                    table.buckets.find(join_hash(nodes, step.join_positions));
+                if (bucket == table.buckets.end())
+                    break;
+                for (std::vector<std::size_t>::const_iterator row = bucket->second.begin();
+                     row != bucket->second.end() && !state.stopped; ++row)
+                {
+                    librdf_node *parts[3];
+                    for (int p = 0; p < 3; ++p)
+                        parts[p] = table.rows[*row * 3 + p].c_obj();
+                    // bind checks the join positions against their values
+                    match(state, i, pattern, parts);
+                }
+                break;
+            }
+        }
+    }
+
+    std::size_t probe_limit_;
+    std::vector<std::string> names_;
+    std::vector<std::vector<Filter> > filters_;
+    std::vector<Pattern> patterns_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_BGP_HPP_INCLUDED */
@@ -0,0 +1,104 @@
+/*
+ * redland_bgp_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "redland.hpp"
+#include "redland_bgp.hpp"
+#include "test_check.hpp"
+
+#define EX(x) "http://example.org/" x
+
+using namespace Redland;
+
+int main()
+{
+    World world;
+    Storage storage(world, "hashes", 0, "hash-type='memory'");
+    Model model(world, storage, 0);
+
+    // 2000 items with 5 properties each, every 100th item is special
+    const Node type(world, "http://www.w3.org/1999/02/22-rdf-syntax-ns#type");
+    const Node item(world, EX("Item"));
+    const Node special(world, EX("Special"));
+    const Node label(world, EX("label"));
+    for (int i = 0; i < 2000; ++i)
+    {
+        const Node subject(world, EX("item") + std::to_string(i));
+        model.add_statement(subject, type, i % 100 ? item : special);
+        for (int p = 0; p < 4; ++p)
+        {
+            const std::string value = std::to_string(i * 4 + p);
+            model.add_statement(subject, Node(world, EX("p") + std::to_string(p)),
+                                Node(world, value.c_str(), 0, false));
+        }
+    }
+    model.add_statement(Node(world, EX("item0")), label, Node(world, "first", 0, false));
+    model.add_statement(Node(world, EX("item100")), label, Node(world, "second", 0, false));
+
+    // ?s rdf:type ex:Special . ?s ?p ?o
+    {
+        BasicGraphPattern bgp(64);
+        const BasicGraphPattern::Variable s = bgp.variable("s"), p = bgp.variable("p"), o = bgp.variable("o");
+        bgp.add(s, type, special);
+        bgp.add(s, p, o);
+
+        std::vector<BasicGraphPattern::Method> methods;
+        const std::vector<std::size_t> order = bgp.plan(model, &methods);
+        CHECK(order.size() == 2 && order[0] == 0 && order[1] == 1);
+        CHECK(methods.size() == 2 && methods[0] == BasicGraphPattern::LOOKUP);
+        // the extent of ?s ?p ?o is the whole model, it must not be hashed
+        CHECK(methods.size() == 2 && methods[1] == BasicGraphPattern::SCAN);
+
+        // 20 special items with 5 statements each, two of them with a label
+        CHECK(bgp.execute(model, [](const BasicGraphPattern::Solution &) { return true; }) == 20 * 5 + 2);
+    }
+
+    // ?s rdf:type ex:Special . ?s ex:label ?l
+    {
+        BasicGraphPattern bgp;
+        const BasicGraphPattern::Variable s = bgp.variable("s"), l = bgp.variable("l");
+        bgp.add(s, type, special);
+        bgp.add(s, label, l);
+
+        std::vector<BasicGraphPattern::Method> methods;
+        bgp.plan(model, &methods);
+        CHECK(methods.size() == 2 && methods[1] == BasicGraphPattern::LOOKUP);
+
+        std::vector<std::vector<Node> > rows(bgp.select(model));
+        CHECK(rows.size() == 2);
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const std::string value = rows[i][l.index].view().literal_value().to_string();
+            CHECK(value == "first" || value == "second");
+        }
+    }
+
+    // ?s ?p ?o is hashed only when the whole extent is below the probe limit,
+    // both methods give the same solutions
+    {
+        std::size_t counts[2];
+        const std::size_t limits[2] = { 64, 100000 };
+        for (int i = 0; i < 2; ++i)
+        {
+            BasicGraphPattern bgp(limits[i]);
+            const BasicGraphPattern::Variable s = bgp.variable("s"), p = bgp.variable("p"), o = bgp.variable("o");
+            bgp.add(s, type, special);
+            bgp.add(s, p, o);
+
+            std::vector<BasicGraphPattern::Method> methods;
+            bgp.plan(model, &methods);
+            CHECK(methods.size() == 2 && methods[1] == (i ? BasicGraphPattern::HASH_JOIN : BasicGraphPattern::SCAN));
+            counts[i] = bgp.execute(model, [](const BasicGraphPattern::Solution &) { return true; });
+        }
+        CHECK(counts[0] == 20 * 5 + 2 && counts[1] == counts[0]);
+    }
+
+    return test_exit_status();
+}
@@ -0,0 +1,1061 @@
+/*
+ * redland_columnar_storage.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_COLUMNAR_STORAGE_HPP_INCLUDED
+#define RDW_COLUMNAR_STORAGE_HPP_INCLUDED
+
+#include "redland.hpp"
+#include "redland_iri_pool.hpp"
+#include <rdf_storage_module.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <map>
+#include <memory>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * librdf storage module with integer encoded, sorted columnar indexes.
+ *
+ * Terms are interned into 32 bit ids. Statements are kept in three sorted
+ * indexes (SPO, POS, OSP), each index as three id columns, which is 36
+ * bytes per statement plus one copy of every distinct term. Terms are
+ * never removed from the dictionary. With the iri-pool option IRIs are
+ * kept in an IriPool instead of as librdf nodes, which takes a fraction of
+ * their memory, but every IRI returned by a stream or iterator is a new
+ * node decoded from the pool.
+ *
+ * The sorted columns of an index are immutable. Writes go to a small
+ * sorted delta per index, removals are tombstones in the delta. Reads
+ * probe the delta, the delta being merged and the columns together, so
+ * reads never wait for a merge. When the delta outgrows a fraction of the
+ * index it is frozen and merged into new columns on a background thread.
+ *
+ * Register the module once per world, then use it by name:
+ *
+ *     ColumnarStorage::register_factory(world);
+ *     Storage storage(world, "rdfparse-columnar", "db", "iri-pool='yes'");
+ *     Model model(world, storage, "");
+ *
+ * Contexts are not supported. Streams see the statements at the time they
+ * were created and stay valid when the storage is modified. The storage
+ * reports its changes to the listener of its Model, so statistics kept by
+ * a listener cost no extra lookups.
+ */
+class ColumnarStorage : public ReportingStorage
+{
+public:
+
+    typedef uint32_t TermId;
+
+    /** Smallest delta that is merged into the columns */
+    enum { min_merge_size = 4096 };
+
+    /**
+     * Register the storage factory under name with world, does nothing
+     * when a storage of this name is already registered.
+     */
+    static bool register_factory(const World &world, const char *name = "rdfparse-columnar")
+    {
+        const char *registered = 0;
+        for (unsigned i = 0; librdf_storage_enumerate(world.c_obj(), i, &registered, 0) == 0; ++i)
+        {
+            if (registered && std::strcmp(registered, name) == 0)
+                return true;
+        }
+        return librdf_storage_register_factory(world.c_obj(), name,
+            "Columnar in-memory storage", &fill_factory) == 0;
+    }
+
+    std::size_t num_terms() const { return terms_.size() + (iris_ ? iris_->size() : 0); }
+
+    /** Pool of the IRIs, 0 without the iri-pool option */
+    const IriPool * iri_pool() const { return iris_.get(); }
+
+    std::size_t size() const { return size_; }
+
+    virtual void set_listener(StatementListener *listener) { listener_ = listener; }
+
+    /** Returns false when the statement was already stored */
+    bool add(librdf_statement *statement)
+    {
+        Triple triple;
+        triple.t[0] = intern(librdf_statement_get_subject(statement));
+        triple.t[1] = intern(librdf_statement_get_predicate(statement));
+        triple.t[2] = intern(librdf_statement_get_object(statement));
+        poll();
+        if (indexes_[SPO].contains(triple))
+            return false;
+        for (int i = 0; i < NUM_INDEXES; ++i)
+            indexes_[i].set(triple, true);
+        ++size_;
+        after_write();
+        if (listener_)
+            listener_->statement_added(statement);
+        return true;
+    }
+
+    /** Returns false when the statement was not stored */
+    bool remove(librdf_statement *statement)
+    {
+        Triple triple;
+        if (!lookup(statement, triple))
+            return false;
+        poll();
+        if (!indexes_[SPO].contains(triple))
+            return false;
+        for (int i = 0; i < NUM_INDEXES; ++i)
+            indexes_[i].set(triple, false);
+        --size_;
+        after_write();
+        if (listener_)
+            listener_->statement_removed(statement);
+        return true;
+    }
+
+    bool contains(librdf_statement *statement)
+    {
+        Triple triple;
+        if (!lookup(statement, triple))
+            return false;
+        poll();
+        return indexes_[SPO].contains(triple);
+    }
+
+    /** Merge all deltas into the columns now and wait for the merges */
+    void flush()
+    {
+        for (int i = 0; i < NUM_INDEXES; ++i)
+            indexes_[i].merge_now();
+    }
+
+private:
+
+    enum { SPO, POS, OSP, NUM_INDEXES };
+
+    typedef std::pair<std::size_t, std::size_t> Range;
+
+    /** Term ids, in subject, predicate, object order or in index order */
+    struct Triple
+    {
+        TermId t[3];
+    };
+
+    struct TripleLess
+    {
+        bool operator()(const Triple &a, const Triple &b) const
+        {
+            return std::lexicographical_compare(a.t, a.t + 3, b.t, b.t + 3);
+        }
+    };
+
+    static bool equal(const Triple &a, const Triple &b)
+    {
+        return a.t[0] == b.t[0] && a.t[1] == b.t[1] && a.t[2] == b.t[2];
+    }
+
+    /** Delta entry, present is false for a tombstone */
+    struct Entry
+    {
+        Triple key;
+        bool present;
+    };
+
+    struct EntryLess
+    {
+        bool operator()(const Entry &a, const Triple &b) const { return TripleLess()(a.key, b); }
+        bool operator()(const Triple &a, const Entry &b) const { return TripleLess()(a, b.key); }
+    };
+
+    typedef std::vector<Entry> Entries;
+    typedef std::map<Triple, bool, TripleLess> Delta;
+
+    /** Immutable sorted id columns of an index */
+    struct Columns
+    {
+        std::vector<TermId> c[3];
+
+        std::size_t size() const { return c[0].size(); }
+
+        void get(std::size_t row, Triple &key) const
+        {
+            for (int i = 0; i < 3; ++i)
+                key.t[i] = c[i][row];
+        }
+
+        /** Rows whose first n columns equal key */
+        Range range(const TermId *key, int n) const
+        {
+            std::size_t first = 0, last = size();
+            for (int i = 0; i < n && first != last; ++i)
+            {
+                std::vector<TermId>::const_iterator begin = c[i].begin();
+                first = std::lower_bound(begin + first, begin + last, key[i]) - begin;
+                last = std::upper_bound(begin + first, begin + last, key[i]) - begin;
+            }
+            return Range(first, last);
+        }
+    };
+
+    typedef std::shared_ptr<const Columns> ColumnsPtr;
+    typedef std::shared_ptr<const Entries> EntriesPtr;
+
+    /** Smallest and largest key with the first n ids of prefix */
+    static void key_bounds(const TermId *prefix, int n, Triple &low, Triple &high)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            low.t[i] = i < n ? prefix[i] : 0;
+            high.t[i] = i < n ? prefix[i] : std::numeric_limits<TermId>::max();
+        }
+    }
+
+    /**
+     * Sorted keys of an index with a given prefix, merged from the delta,
+     * the frozen delta and the columns. Newer layers win, tombstones hide
+     * older entries. The cursor keeps its own snapshot of all layers.
+     */
+    class Cursor
+    {
+    public:
+
+        Cursor()
+            : row_(0), row_end_(0), frozen_pos_(0), frozen_end_(0), delta_pos_(0), valid_(false)
+        { }
+
+        Cursor(const ColumnsPtr &columns, const EntriesPtr &frozen, const Delta &delta,
+               const TermId *prefix, int n)
+            : columns_(columns)
+            , frozen_(frozen)
+            , frozen_pos_(0)
+            , frozen_end_(0)
+            , delta_pos_(0)
+            , valid_(false)
+        {
+            const Range range = columns_->range(prefix, n);
+            row_ = range.first;
+            row_end_ = range.second;
+
+            Triple low, high;
+            key_bounds(prefix, n, low, high);
+            if (frozen_)
+            {
+                frozen_pos_ = std::lower_bound(frozen_->begin(), frozen_->end(), low, EntryLess()) - frozen_->begin();
+                frozen_end_ = std::upper_bound(frozen_->begin(), frozen_->end(), high, EntryLess()) - frozen_->begin();
+            }
+            for (Delta::const_iterator it = delta.lower_bound(low), end = delta.upper_bound(high); it != end; ++it)
+            {
+                const Entry entry = { it->first, it->second };
+                delta_.push_back(entry);
+            }
+            find();
+        }
+
+        bool valid() const { return valid_; }
+
+        /** Current key in index order */
+        const Triple & key() const { return key_; }
+
+        void next() { find(); }
+
+    private:
+
+        void find()
+        {
+            for (;;)
+            {
+                Triple row_key;
+                bool have = false;
+                if (row_ < row_end_)
+                {
+                    columns_->get(row_, row_key);
+                    key_ = row_key;
+                    have = true;
+                }
+                if (frozen_pos_ < frozen_end_ && (!have || TripleLess()((*frozen_)[frozen_pos_].key, key_)))
+                {
+                    key_ = (*frozen_)[frozen_pos_].key;
+                    have = true;
+                }
+                if (delta_pos_ < delta_.size() && (!have || TripleLess()(delta_[delta_pos_].key, key_)))
+                {
+                    key_ = delta_[delta_pos_].key;
+                    have = true;
+                }
+                if (!have)
+                {
+                    valid_ = false;
+                    return;
+                }
+
+                bool present = false;
+                if (row_ < row_end_ && equal(row_key, key_))
+                {
+                    present = true;
+                    ++row_;
+                }
+                if (frozen_pos_ < frozen_end_ && equal((*frozen_)[frozen_pos_].key, key_))
+                    present = (*frozen_)[frozen_pos_++].present;
+                if (delta_pos_ < delta_.size() && equal(delta_[delta_pos_].key, key_))
+                    present = delta_[delta_pos_++].present;
+                if (present)
+                {
+                    valid_ = true;
+                    return;
+                }
+            }
+        }
+
+        ColumnsPtr columns_;
+        std::size_t row_;
+        std::size_t row_end_;
+        EntriesPtr frozen_;
+        std::size_t frozen_pos_;
+        std::size_t frozen_end_;
+        Entries delta_;
+        std::size_t delta_pos_;
+        Triple key_;
+        bool valid_;
+    };
+
+    /**
+     * Index over one permutation, column i holds position order[i] of the
+     * statement.
+     */
+    class Index
+    {
+    public:
+
+        Index()
+            : columns_(std::make_shared<Columns>())
+        {
+            init(0);
+        }
+
+        Index(const Index &) = delete;
+        Index & operator=(const Index &) = delete;
+
+        void init(int first)
+        {
+            for (int i = 0; i < 3; ++i)
+                order_[i] = (first + i) % 3;
+        }
+
+        void key(const Triple &triple, Triple &key) const
+        {
+            for (int i = 0; i < 3; ++i)
+                key.t[i] = triple.t[order_[i]];
+        }
+
+        void triple(const Triple &key, Triple &triple) const
+        {
+            for (int i = 0; i < 3; ++i)
+                triple.t[order_[i]] = key.t[i];
+        }
+
+        bool contains(const Triple &triple) const
+        {
+            Triple k;
+            key(triple, k);
+            Delta::const_iterator it = delta_.find(k);
+            if (it != delta_.end())
+                return it->second;
+            if (frozen_)
+            {
+                Entries::const_iterator e = std::lower_bound(frozen_->begin(), frozen_->end(), k, EntryLess());
+                if (e != frozen_->end() && equal(e->key, k))
+                    return e->present;
+            }
+            const Range range = columns_->range(k.t, 3);
+            return range.first != range.second;
+        }
+
+        void set(const Triple &triple, bool present)
+        {
+            Triple k;
+            key(triple, k);
+            delta_[k] = present;
+        }
+
+        /** Keys whose first n ids equal prefix */
+        Cursor find(const TermId *prefix, int n) const
+        {
+            return Cursor(columns_, frozen_, delta_, prefix, n);
+        }
+
+        /** Install a finished background merge */
+        void poll()
+        {
+            if (merging_.valid() && merging_.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                finish_merge();
+        }
+
+        /**
+         * Start a background merge when the delta reached threshold. Writes
+         * only wait for a running merge when the delta grows much larger.
+         */
+        void maybe_merge(std::size_t threshold)
+        {
+            if (delta_.size() < threshold)
+                return;
+            if (merging_.valid())
+            {
+                if (delta_.size() < 4 * threshold)
+                    return;
+                finish_merge();
+            }
+            start_merge();
+        }
+
+        void merge_now()
+        {
+            finish_merge();
+            if (!delta_.empty())
+            {
+                start_merge();
+                finish_merge();
+            }
+        }
+
+    private:
+
+        void start_merge()
+        {
+            std::shared_ptr<Entries> frozen = std::make_shared<Entries>();
+            frozen->reserve(delta_.size());
+            for (Delta::const_iterator it = delta_.begin(); it != delta_.end(); ++it)
+            {
+                const Entry entry = { it->first, it->second };
+                frozen->push_back(entry);
+            }
+            delta_.clear();
+            frozen_ = frozen;
+
+            const ColumnsPtr columns = columns_;
+            const EntriesPtr entries = frozen_;
+            try
+            {
+                merging_ = std::async(std::launch::async, [columns, entries]() { return merge(*columns, *entries); });
+            }
+            catch (const std::system_error &)
+            {
+                // no thread available, merge in place
+                columns_ = merge(*columns, *entries);
+                frozen_.reset();
+            }
+        }
+
+        void finish_merge()
+        {
+            if (!merging_.valid())
+                return;
+            columns_ = merging_.get();
+            frozen_.reset();
+        }
+
+        static Triple row_key(const Columns &columns, std::size_t row)
+        {
+            Triple key;
+            columns.get(row, key);
+            return key;
+        }
+
+        static bool row_less(const Columns &columns, std::size_t row, const Triple &key)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                if (columns.c[i][row] != key.t[i])
+                    return columns.c[i][row] < key.t[i];
+            }
+            return false;
+        }
+
+        static ColumnsPtr merge(const Columns &columns, const Entries &entries)
+        {
+            std::shared_ptr<Columns> merged = std::make_shared<Columns>();
+            for (int i = 0; i < 3; ++i)
+                merged->c[i].reserve(columns.size() + entries.size());
+            std::size_t row = 0, k = 0;
+            while (row < columns.size() || k < entries.size())
+            {
+                if (k == entries.size() || (row < columns.size() && row_less(columns, row, entries[k].key)))
+                {
+                    for (int i = 0; i < 3; ++i)
+                        merged->c[i].push_back(columns.c[i][row]);
+                    ++row;
+                    continue;
+                }
+                // entry replaces an equal row
+                if (row < columns.size() && !row_less(columns, row, entries[k].key) &&
+                    !TripleLess()(entries[k].key, row_key(columns, row)))
+                    ++row;
+                if (entries[k].present)
+                {
+                    for (int i = 0; i < 3; ++i)
+                        merged->c[i].push_back(entries[k].key.t[i]);
+                }
+                ++k;
+            }
+            return merged;
+        }
+
+        int order_[3];
+        ColumnsPtr columns_;
+        EntriesPtr frozen_;
+        Delta delta_;
+        std::future<ColumnsPtr> merging_;
+    };
+
+    /** Index and key prefix answering a statement pattern */
+    struct Pattern
+    {
+        int index;
+        int num_bound;
+        TermId key[3];
+    };
+
+    /** Ids of pooled IRIs are their pool id with this bit set */
+    static const TermId pooled_bit = 0x80000000u;
+
+    explicit ColumnarStorage(librdf_world *world = 0, bool pool_iris = false)
+        : world_(world)
+        , iris_(pool_iris ? new IriPool() : 0)
+        , size_(0)
+        , listener_(0)
+    {
+        indexes_[SPO].init(0);
+        indexes_[POS].init(1);
+        indexes_[OSP].init(2);
+    }
+
+    void poll()
+    {
+        for (int i = 0; i < NUM_INDEXES; ++i)
+            indexes_[i].poll();
+    }
+
+    void after_write()
+    {
+        const std::size_t threshold = std::max<std::size_t>(min_merge_size, size_ / 8);
+        for (int i = 0; i < NUM_INDEXES; ++i)
+            indexes_[i].maybe_merge(threshold);
+    }
+
+    static bool is_pooled(TermId id) { return (id & pooled_bit) != 0; }
+
+    bool pooled(librdf_node *node) const
+    {
+        return iris_ && librdf_node_get_type(node) == LIBRDF_NODE_TYPE_RESOURCE;
+    }
+
+    static StringRef iri(librdf_node *node)
+    {
+        size_t length = 0;
+        const unsigned char *value = librdf_uri_as_counted_string(librdf_node_get_uri(node), &length);
+        return StringRef(reinterpret_cast<const char *>(value), length);
+    }
+
+    TermId intern(librdf_node *node)
+    {
+        if (pooled(node))
+        {
+            const IriPool::IriId id = iris_->intern(iri(node));
+            if (id >= pooled_bit)
+                throw Exception("ColumnarStorage: too many IRIs");
+            return id | pooled_bit;
+        }
+        std::unordered_map<librdf_node *, TermId, NodeHash, NodeEqual>::const_iterator it = ids_.find(node);
+        if (it != ids_.end())
+            return it->second;
+        Node copy(librdf_new_node_from_node(node));
+        if (!copy.is_valid())
+            throw AllocException("librdf_new_node_from_node");
+        if (terms_.size() + 1 >= pooled_bit)
+            throw Exception("ColumnarStorage: too many terms");
+        terms_.push_back(std::move(copy));
+        const TermId id = static_cast<TermId>(terms_.size());
+        ids_.insert(std::make_pair(terms_.back().c_obj(), id));
+        return id;
+    }
+
+    /** Id of node, 0 when it does not occur in the storage */
+    TermId find_id(librdf_node *node) const
+    {
+        if (pooled(node))
+        {
+            const IriPool::IriId id = iris_->find(iri(node));
+            return id != IriPool::npos ? id | pooled_bit : 0;
+        }
+        std::unordered_map<librdf_node *, TermId, NodeHash, NodeEqual>::const_iterator it = ids_.find(node);
+        return it != ids_.end() ? it->second : 0;
+    }
+
+    /** Node of a term that is not pooled, owned by the dictionary */
+    librdf_node * term(TermId id) const { return terms_[id - 1].c_obj(); }
+
+    /** New node of any term, 0 when it could not be allocated */
+    librdf_node * new_term(TermId id)
+    {
+        if (!is_pooled(id))
+            return librdf_new_node_from_node(term(id));
+        scratch_.clear();
+        iris_->append_to(id & ~pooled_bit, scratch_);
+        return librdf_new_node_from_counted_uri_string(world_,
+            reinterpret_cast<const unsigned char *>(scratch_.data()), scratch_.size());
+    }
+
+    bool lookup(librdf_statement *statement, Triple &triple) const
+    {
+        return (triple.t[0] = find_id(librdf_statement_get_subject(statement)))
+            && (triple.t[1] = find_id(librdf_statement_get_predicate(statement)))
+            && (triple.t[2] = find_id(librdf_statement_get_object(statement)));
+    }
+
+    /**
+     * Pick the index with the longest bound key prefix, false when a bound
+     * node does not occur in the storage.
+     */
+    bool make_pattern(librdf_node *subject, librdf_node *predicate, librdf_node *object, Pattern &pattern) const
+    {
+        const TermId s = subject ? find_id(subject) : 0;
+        const TermId p = predicate ? find_id(predicate) : 0;
+        const TermId o = object ? find_id(object) : 0;
+        if ((subject && !s) || (predicate && !p) || (object && !o))
+            return false;
+
+        if (s && (p || !o))
+            set_pattern(pattern, SPO, s, p, o);
+        else if (p)
+            set_pattern(pattern, POS, p, o, 0);
+        else if (o)
+            set_pattern(pattern, OSP, o, s, 0);
+        else
+            set_pattern(pattern, SPO, 0, 0, 0);
+        return true;
+    }
+
+    static void set_pattern(Pattern &pattern, int index, TermId a, TermId b, TermId c)
+    {
+        pattern.index = index;
+        pattern.key[0] = a;
+        pattern.key[1] = b;
+        pattern.key[2] = c;
+        pattern.num_bound = !a ? 0 : !b ? 1 : !c ? 2 : 3;
+    }
+
+    /** Ids in column of the keys matching the prefix of index */
+    void collect(int index, TermId a, TermId b, int num_bound, int column, std::vector<TermId> &ids)
+    {
+        poll();
+        const TermId key[3] = { a, b, 0 };
+        for (Cursor cursor = indexes_[index].find(key, num_bound); cursor.valid(); cursor.next())
+            ids.push_back(cursor.key().t[column]);
+    }
+
+    bool has_rows(int index, TermId a, TermId b)
+    {
+        poll();
+        const TermId key[3] = { a, b, 0 };
+        return indexes_[index].find(key, 2).valid();
+    }
+
+    librdf_world *world_;
+    std::unique_ptr<IriPool> iris_;
+    std::string scratch_;
+    std::vector<Node> terms_;
+    std::unordered_map<librdf_node *, TermId, NodeHash, NodeEqual> ids_;
+    Index indexes_[NUM_INDEXES];
+    std::size_t size_;
+    StatementListener *listener_;
+
+    // librdf storage module
+
+    static ColumnarStorage * instance(librdf_storage *storage)
+    {
+        return static_cast<ColumnarStorage *>(librdf_storage_get_instance(storage));
+    }
+
+    struct StatementStream
+    {
+        ColumnarStorage *self;
+        const Index *index;
+        Cursor cursor;
+        librdf_statement *statement;
+
+        static int is_end(void *ctx)
+        {
+            return !static_cast<StatementStream *>(ctx)->cursor.valid();
+        }
+
+        static int next(void *ctx)
+        {
+            StatementStream *s = static_cast<StatementStream *>(ctx);
+            if (s->cursor.valid())
+                s->cursor.next();
+            return !s->cursor.valid();
+        }
+
+        static void * get(void *ctx, int flags)
+        {
+            StatementStream *s = static_cast<StatementStream *>(ctx);
+            if (flags != LIBRDF_STREAM_GET_METHOD_GET_OBJECT || !s->cursor.valid())
+                return 0;
+            // dictionary nodes are shared by reference, only pooled IRIs are allocated
+            Triple triple;
+            s->index->triple(s->cursor.key(), triple);
+            librdf_statement_clear(s->statement);
+            librdf_statement_set_subject(s->statement, s->self->new_term(triple.t[0]));
+            librdf_statement_set_predicate(s->statement, s->self->new_term(triple.t[1]));
+            librdf_statement_set_object(s->statement, s->self->new_term(triple.t[2]));
+            return s->statement;
+        }
+
+        static void finished(void *ctx)
+        {
+            StatementStream *s = static_cast<StatementStream *>(ctx);
+            librdf_free_statement(s->statement);
+            delete s;
+        }
+    };
+
+    struct NodeIterator
+    {
+        ColumnarStorage *self;
+        std::vector<TermId> ids;
+        std::size_t current;
+        // decoded pooled IRI returned by get
+        Node node;
+
+        static int is_end(void *ctx)
+        {
+            NodeIterator *it = static_cast<NodeIterator *>(ctx);
+            return it->current >= it->ids.size();
+        }
+
+        static int next(void *ctx)
+        {
+            NodeIterator *it = static_cast<NodeIterator *>(ctx);
+            if (it->current < it->ids.size())
+                ++it->current;
+            return it->current >= it->ids.size();
+        }
+
+        static void * get(void *ctx, int flags)
+        {
+            NodeIterator *it = static_cast<NodeIterator *>(ctx);
+            if (flags != LIBRDF_ITERATOR_GET_METHOD_GET_OBJECT || it->current >= it->ids.size())
+                return 0;
+            const TermId id = it->ids[it->current];
+            if (!is_pooled(id))
+                return it->self->term(id);
+            it->node = Node(it->self->new_term(id));
+            return it->node.c_obj();
+        }
+
+        static void finished(void *ctx)
+        {
+            delete static_cast<NodeIterator *>(ctx);
+        }
+    };
+
+    static librdf_stream * new_stream(librdf_storage *storage, int index, const TermId *prefix, int num_bound)
+    {
+        librdf_world *world = librdf_storage_get_world(storage);
+        StatementStream *ctx = new StatementStream();
+        ctx->self = instance(storage);
+        ctx->index = &ctx->self->indexes_[index];
+        ctx->cursor = num_bound >= 0 ? ctx->index->find(prefix, num_bound) : Cursor();
+        ctx->statement = librdf_new_statement(world);
+        if (!ctx->statement)
+        {
+            delete ctx;
+            return 0;
+        }
+        librdf_stream *stream = librdf_new_stream(world, ctx,
+            &StatementStream::is_end, &StatementStream::next, &StatementStream::get, &StatementStream::finished);
+        if (!stream)
+            StatementStream::finished(ctx);
+        return stream;
+    }
+
+    static librdf_iterator * new_iterator(librdf_storage *storage, std::vector<TermId> &ids)
+    {
+        NodeIterator *ctx = new NodeIterator();
+        ctx->self = instance(storage);
+        ctx->ids.swap(ids);
+        ctx->current = 0;
+        librdf_iterator *iterator = librdf_new_iterator(librdf_storage_get_world(storage), ctx,
+            &NodeIterator::is_end, &NodeIterator::next, &NodeIterator::get, &NodeIterator::finished);
+        if (!iterator)
+            delete ctx;
+        return iterator;
+    }
+
+    static librdf_iterator * node_iterator(librdf_storage *storage, int index, librdf_node *a, librdf_node *b,
+                                           int column, bool make_unique)
+    {
+        try
+        {
+            ColumnarStorage *self = instance(storage);
+            std::vector<TermId> ids;
+            const TermId id_a = self->find_id(a);
+            const TermId id_b = b ? self->find_id(b) : 0;
+            if (id_a && (!b || id_b))
+                self->collect(index, id_a, id_b, b ? 2 : 1, column, ids);
+            if (make_unique)
+            {
+                std::sort(ids.begin(), ids.end());
+                ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            }
+            return new_iterator(storage, ids);
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    static int init(librdf_storage *storage, const char *, librdf_hash *options)
+    {
+        bool pool_iris = false;
+        if (options)
+        {
+            pool_iris = librdf_hash_get_as_boolean(options, "iri-pool") > 0;
+            librdf_free_hash(options);
+        }
+        try
+        {
+            std::unique_ptr<ColumnarStorage> self(new ColumnarStorage(librdf_storage_get_world(storage), pool_iris));
+            register_storage(storage, self.get());
+            librdf_storage_set_instance(storage, self.release());
+            return 0;
+        }
+        catch (...)
+        {
+            return 1;
+        }
+    }
+
+    static void terminate(librdf_storage *storage)
+    {
+        unregister_storage(storage);
+        delete instance(storage);
+    }
+
+    static int open(librdf_storage *, librdf_model *)
+    {
+        return 0;
+    }
+
+    static int close(librdf_storage *)
+    {
+        return 0;
+    }
+
+    static int size(librdf_storage *storage)
+    {
+        try
+        {
+            return static_cast<int>(instance(storage)->size());
+        }
+        catch (...)
+        {
+            return -1;
+        }
+    }
+
+    static int add_statement(librdf_storage *storage, librdf_statement *statement)
+    {
+        try
+        {
+            instance(storage)->add(statement);
+            return 0;
+        }
+        catch (...)
+        {
+            return 1;
+        }
+    }
+
+    static int add_statements(librdf_storage *storage, librdf_stream *stream)
+    {
+        try
+        {
+            ColumnarStorage *self = instance(storage);
+            for (; !librdf_stream_end(stream); librdf_stream_next(stream))
+            {
+                if (librdf_statement *statement = librdf_stream_get_object(stream))
+                    self->add(statement);
+            }
+            return 0;
+        }
+        catch (...)
+        {
+            return 1;
+        }
+    }
+
+    static int remove_statement(librdf_storage *storage, librdf_statement *statement)
+    {
+        try
+        {
+            return instance(storage)->remove(statement) ? 0 : 1;
+        }
+        catch (...)
+        {
+            return 1;
+        }
+    }
+
+    static int contains_statement(librdf_storage *storage, librdf_statement *statement)
+    {
+        try
+        {
+            return instance(storage)->contains(statement);
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    static int has_arc_in(librdf_storage *storage, librdf_node *node, librdf_node *property)
+    {
+        try
+        {
+            ColumnarStorage *self = instance(storage);
+            const TermId p = self->find_id(property), o = self->find_id(node);
+            return p && o && self->has_rows(POS, p, o);
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    static int has_arc_out(librdf_storage *storage, librdf_node *node, librdf_node *property)
+    {
+        try
+        {
+            ColumnarStorage *self = instance(storage);
+            const TermId s = self->find_id(node), p = self->find_id(property);
+            return s && p && self->has_rows(SPO, s, p);
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    static librdf_stream * serialise(librdf_storage *storage)
+    {
+        try
+        {
+            ColumnarStorage *self = instance(storage);
+            self->poll();
+            return new_stream(storage, SPO, 0, 0);
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    static librdf_stream * find_statements(librdf_storage *storage, librdf_statement *statement)
+    {
+        try
+        {
+            ColumnarStorage *self = instance(storage);
+            self->poll();
+            Pattern pattern;
+            if (!self->make_pattern(librdf_statement_get_subject(statement),
+                                    librdf_statement_get_predicate(statement),
+                                    librdf_statement_get_object(statement), pattern))
+                return new_stream(storage, SPO, 0, -1);
+            return new_stream(storage, pattern.index, pattern.key, pattern.num_bound);
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    static librdf_iterator * find_sources(librdf_storage *storage, librdf_node *arc, librdf_node *target)
+    {
+        return node_iterator(storage, POS, arc, target, 2, false);
+    }
+
+    static librdf_iterator * find_arcs(librdf_storage *storage, librdf_node *source, librdf_node *target)
+    {
+        return node_iterator(storage, OSP, target, source, 2, false);
+    }
+
+    static librdf_iterator * find_targets(librdf_storage *storage, librdf_node *source, librdf_node *arc)
+    {
+        return node_iterator(storage, SPO, source, arc, 2, false);
+    }
+
+    static librdf_iterator * get_arcs_in(librdf_storage *storage, librdf_node *node)
+    {
+        return node_iterator(storage, OSP, node, 0, 2, true);
+    }
+
+    static librdf_iterator * get_arcs_out(librdf_storage *storage, librdf_node *node)
+    {
+        return node_iterator(storage, SPO, node, 0, 1, true);
+    }
+
+    static int sync(librdf_storage *storage)
+    {
+        try
+        {
+            instance(storage)->flush();
+            return 0;
+        }
+        catch (...)
+        {
+            return 1;
+        }
+    }
+
+    static void fill_factory(librdf_storage_factory *factory)
+    {
+        factory->version = LIBRDF_STORAGE_INTERFACE_VERSION;
+        factory->init = &init;
+        factory->terminate = &terminate;
+        factory->open = &open;
+        factory->close = &close;
+        factory->size = &size;
+        factory->add_statement = &add_statement;
+        factory->add_statements = &add_statements;
+        factory->remove_statement = &remove_statement;
+        factory->contains_statement = &contains_statement;
+        factory->has_arc_in = &has_arc_in;
+        factory->has_arc_out = &has_arc_out;
+        factory->serialise = &serialise;
+        factory->find_statements = &find_statements;
+        factory->find_sources = &find_sources;
+        factory->find_arcs = &find_arcs;
+        factory->find_targets = &find_targets;
+        factory->get_arcs_in = &get_arcs_in;
+        factory->get_arcs_out = &get_arcs_out;
+        factory->sync = &sync;
+    }
+};
+
+} // namespace Redland
+
+#endif /* RDW_COLUMNAR_STORAGE_HPP_INCLUDED */
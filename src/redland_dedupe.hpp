@@ -0,0 +1,351 @@
+/*
+ * redland_dedupe.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_DEDUPE_HPP_INCLUDED
+#define RDW_DEDUPE_HPP_INCLUDED
+
+#include "redland.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * 128-bit statement fingerprint, built from the content of the terms.
+ */
+struct Fingerprint
+{
+    uint64_t hi;
+    uint64_t lo;
+
+    bool operator==(const Fingerprint &other) const
+    {
+        return hi == other.hi && lo == other.lo;
+    }
+};
+
+class FingerprintBuilder
+{
+public:
+
+    enum TermTag
+    {
+        URI_TAG = 1, LITERAL_TAG = 2, BLANK_TAG = 3, DATATYPE_TAG = 4, LANGUAGE_TAG = 5, NONE_TAG = 6
+    };
+
+    FingerprintBuilder()
+        : a_(14695981039346656037ULL)
+        , b_(0x9E3779B97F4A7C15ULL)
+    { }
+
+    void add(TermTag tag, const unsigned char *s, std::size_t length)
+    {
+        mix(static_cast<unsigned char>(tag));
+        for (std::size_t i = 0; i < length; ++i)
+            mix(s[i]);
+        // length terminates the term, so "ab"+"c" differs from "a"+"bc"
+        for (int i = 0; i < 8; ++i)
+            mix(static_cast<unsigned char>(length >> (i * 8)));
+    }
+
+    void add_node(librdf_node *node)
+    {
+        if (!node)
+        {
+            add(NONE_TAG, 0, 0);
+            return;
+        }
+        size_t length = 0;
+        switch (librdf_node_get_type(node))
+        {
+            case LIBRDF_NODE_TYPE_RESOURCE:
+            {
+                const unsigned char *s = librdf_uri_as_counted_string(librdf_node_get_uri(node), &length);
+                add(URI_TAG, s, length);
+                break;
+            }
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                const unsigned char *s = librdf_node_get_literal_value_as_counted_string(node, &length);
+                add(LITERAL_TAG, s, length);
+                if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                {
+                    s = librdf_uri_as_counted_string(datatype, &length);
+                    add(DATATYPE_TAG, s, length);
+                }
+                if (const char *language = librdf_node_get_literal_value_language(node))
+                    add(LANGUAGE_TAG, reinterpret_cast<const unsigned char *>(language), std::strlen(language));
+                break;
+            }
+            case LIBRDF_NODE_TYPE_BLANK:
+            {
+                const unsigned char *s = librdf_node_get_counted_blank_identifier(node, &length);
+                add(BLANK_TAG, s, length);
+                break;
+            }
+            default:
+                add(NONE_TAG, 0, 0);
+                break;
+        }
+    }
+
+    void add_statement(librdf_statement *statement)
+    {
+        add_node(librdf_statement_get_subject(statement));
+        add_node(librdf_statement_get_predicate(statement));
+        add_node(librdf_statement_get_object(statement));
+    }
+
+    Fingerprint finish() const
+    {
+        Fingerprint fp;
+        fp.hi = fmix(a_);
+        fp.lo = fmix(b_ ^ a_);
+        // all zero marks an empty slot in StatementDeduplicator
+        if (fp.hi == 0 && fp.lo == 0)
+            fp.lo = 1;
+        return fp;
+    }
+
+private:
+
+    void mix(unsigned char c)
+    {
+        a_ = (a_ ^ c) * 1099511628211ULL;
+        b_ = (b_ + c) * 0xFF51AFD7ED558CCDULL;
+        b_ ^= b_ >> 29;
+    }
+
+    static uint64_t fmix(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDULL;
+        k ^= k >> 33;
+        k *= 0xC4CEB9FE1A85EC53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    uint64_t a_;
+    uint64_t b_;
+};
+
+struct DedupeStats
+{
+    std::size_t seen;
+    std::size_t unique;
+    std::size_t duplicates;
+    std::size_t probable_duplicates;
+
+    DedupeStats()
+        : seen(0), unique(0), duplicates(0), probable_duplicates(0)
+    { }
+
+    /** Fraction of seen statements that were certain duplicates */
+    double dedupe_ratio() const
+    {
+        return seen ? double(duplicates) / double(seen) : 0.0;
+    }
+};
+
+/**
+ * Streaming statement de-duplication.
+ *
+ * Fingerprints are kept in an open addressing hash set that grows up to
+ * half of the memory cap. When it can not grow any more, further new
+ * fingerprints go to a Bloom filter that uses the other half. Hits in the
+ * exact set are certain duplicates, hits in the Bloom filter are only
+ * probable duplicates and are reported as such.
+ */
+class StatementDeduplicator
+{
+public:
+
+    enum Result
+    {
+        UNIQUE,
+        DUPLICATE,
+        PROBABLE_DUPLICATE
+    };
+
+    explicit StatementDeduplicator(std::size_t memory_cap = 64 * 1024 * 1024)
+        : memory_cap_(memory_cap)
+        , size_(0)
+        , mask_(0)
+        , bloom_mask_(0)
+    {
+        std::size_t slots = 1024;
+        while (slots * sizeof(Fingerprint) > memory_cap_ / 2 && slots > 16)
+            slots >>= 1;
+        table_.resize(slots);
+        mask_ = slots - 1;
+    }
+
+    const DedupeStats & stats() const { return stats_; }
+
+    /** True as long as the Bloom filter fallback was not needed */
+    bool is_exact() const { return bloom_.empty(); }
+
+    Result test_and_insert(const Fingerprint &fp)
+    {
+        stats_.seen++;
+
+        std::size_t slot = static_cast<std::size_t>(fp.lo) & mask_;
+        while (!is_empty(table_[slot]))
+        {
+            if (table_[slot] == fp)
+            {
+                stats_.duplicates++;
+                return DUPLICATE;
+            }
+            slot = (slot + 1) & mask_;
+        }
+
+        bool has_room = (size_ + 1) * 4 <= table_.size() * 3;
+        if (!has_room && grow())
+        {
+            slot = find_empty(fp);
+            has_room = true;
+        }
+        if (has_room)
+        {
+            table_[slot] = fp;
+            size_++;
+            stats_.unique++;
+            return UNIQUE;
+        }
+
+        if (bloom_test_and_set(fp))
+        {
+            stats_.probable_duplicates++;
+            return PROBABLE_DUPLICATE;
+        }
+        stats_.unique++;
+        return UNIQUE;
+    }
+
+    Result test_and_insert(const Statement &statement)
+    {
+        FingerprintBuilder builder;
+        builder.add_statement(statement.c_obj());
+        return test_and_insert(builder.finish());
+    }
+
+    /**
+     * Add statement to the model unless it is a certain duplicate.
+     * Probable duplicates are passed to the model, which does the exact check.
+     */
+    bool add_statement(Model &model, const Statement &statement)
+    {
+        if (test_and_insert(statement) == DUPLICATE)
+            return false;
+        return model.add_statement(statement);
+    }
+
+    /**
+     * Filter duplicates out of stream, e.g. between Parser::parse_as_stream
+     * and Serializer::serialize_stream. The deduplicator must outlive the
+     * stream. When drop_probable is true, probable duplicates are dropped as
+     * well, which may lose unique statements once the Bloom filter is used.
+     */
+    bool apply(Stream &stream, bool drop_probable = false)
+    {
+        return stream.add_map(drop_probable ? &StatementDeduplicator::map_drop_probable
+                                            : &StatementDeduplicator::map_keep_probable,
+                              0, this);
+    }
+
+private:
+
+    static bool is_empty(const Fingerprint &fp)
+    {
+        return fp.hi == 0 && fp.lo == 0;
+    }
+
+    std::size_t find_empty(const Fingerprint &fp) const
+    {
+        std::size_t slot = static_cast<std::size_t>(fp.lo) & mask_;
+        while (!is_empty(table_[slot]))
+            slot = (slot + 1) & mask_;
+        return slot;
+    }
+
+    bool grow()
+    {
+        const std::size_t slots = table_.size() * 2;
+        if (slots * sizeof(Fingerprint) > memory_cap_ / 2)
+        {
+            if (bloom_.empty())
+            {
+                std::size_t words = 1;
+                while ((words * 2) * sizeof(uint64_t) <= memory_cap_ / 2)
+                    words *= 2;
+                bloom_.assign(words, 0);
+                bloom_mask_ = words * 64 - 1;
+            }
+            return false;
+        }
+
+        std::vector<Fingerprint> old(slots);
+        old.swap(table_);
+        mask_ = slots - 1;
+        for (std::vector<Fingerprint>::const_iterator it = old.begin(); it != old.end(); ++it)
+        {
+            if (!is_empty(*it))
+                table_[find_empty(*it)] = *it;
+        }
+        return true;
+    }
+
+    bool bloom_test_and_set(const Fingerprint &fp)
+    {
+        // k = 4 probes by double hashing
+        bool present = true;
+        for (uint64_t i = 0; i < 4; ++i)
+        {
+            const uint64_t bit = (fp.hi + i * fp.lo) & bloom_mask_;
+            uint64_t &word = bloom_[bit >> 6];
+            const uint64_t mask = uint64_t(1) << (bit & 63);
+            if (!(word & mask))
+            {
+                present = false;
+                word |= mask;
+            }
+        }
+        return present;
+    }
+
+    static librdf_statement * map_keep_probable(librdf_stream *, void *context, librdf_statement *statement)
+    {
+        StatementDeduplicator *self = static_cast<StatementDeduplicator *>(context);
+        FingerprintBuilder builder;
+        builder.add_statement(statement);
+        return self->test_and_insert(builder.finish()) == DUPLICATE ? 0 : statement;
+    }
+
+    static librdf_statement * map_drop_probable(librdf_stream *, void *context, librdf_statement *statement)
+    {
+        StatementDeduplicator *self = static_cast<StatementDeduplicator *>(context);
+        FingerprintBuilder builder;
+        builder.add_statement(statement);
+        return self->test_and_insert(builder.finish()) == UNIQUE ? statement : 0;
+    }
+
+    std::size_t memory_cap_;
+    std::vector<Fingerprint> table_;
+    std::size_t size_;
+    std::size_t mask_;
+    std::vector<uint64_t> bloom_;
+    uint64_t bloom_mask_;
+    DedupeStats stats_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_DEDUPE_HPP_INCLUDED */
@@ -0,0 +1,286 @@
+/*
+ * redland_iri_pool.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_IRI_POOL_HPP_INCLUDED
+#define RDW_IRI_POOL_HPP_INCLUDED
+
+#include "redland.hpp"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Prefix-compressed pool of interned IRIs.
+ *
+ * Every IRI is split at its last '/', '#' or ':' into a namespace, stored
+ * once per pool, and a local name. Local names are front coded against
+ * the previous local name of the same namespace, so sequential names like
+ * UUID1, UUID2, ... cost a few bytes each. Every restart_interval-th name
+ * of a namespace is stored in full, which bounds the decoding work.
+ *
+ * An IRI is a 4 byte offset plus its encoded namespace id and suffix and
+ * a 4 byte hash slot, the encoded data is limited to 4 GiB. Interned IRIs
+ * are equal exactly when their ids are equal. Lookups use a scratch
+ * buffer, so even const access must not be concurrent.
+ *
+ * For 200000 IRIs http://test.arvida.de/UUID<n> the pool takes about two
+ * thirds of the raw string bytes after shrink_to_fit, most of it for the
+ * hash slots, while librdf URI nodes holding the same IRIs take about four
+ * times the raw bytes. ColumnarStorage keeps its IRIs in a pool with its
+ * iri-pool option.
+ */
+class IriPool
+{
+public:
+
+    typedef uint32_t IriId;
+
+    static const IriId npos = static_cast<IriId>(-1);
+
+    explicit IriPool(unsigned restart_interval = 16)
+        : restart_interval_(restart_interval ? restart_interval : 1)
+        , raw_bytes_(0)
+        , slots_(1024, 0)
+    { }
+
+    std::size_t size() const { return entries_.size(); }
+
+    std::size_t num_namespaces() const { return namespaces_.size(); }
+
+    /** Total length of all interned IRIs, for comparison with memory_usage() */
+    std::size_t raw_bytes() const { return raw_bytes_; }
+
+    /** Approximate heap memory used by the pool */
+    std::size_t memory_usage() const
+    {
+        std::size_t bytes = chars_.capacity() + entries_.capacity() * sizeof(uint32_t)
+            + slots_.capacity() * sizeof(uint32_t) + namespaces_.capacity() * sizeof(NamespaceState);
+        for (std::vector<NamespaceState>::const_iterator it = namespaces_.begin(); it != namespaces_.end(); ++it)
+            bytes += it->name.capacity() + it->last_suffix.capacity();
+        return bytes;
+    }
+
+    /** Release the spare capacity of the pool, e.g. after a bulk load */
+    void shrink_to_fit()
+    {
+        chars_.shrink_to_fit();
+        entries_.shrink_to_fit();
+    }
+
+    IriId intern(StringRef iri)
+    {
+        const std::size_t hash = hash_bytes(iri);
+        std::size_t slot = find_slot(iri, hash);
+        if (slots_[slot])
+            return slots_[slot] - 1;
+
+        const std::size_t split = split_position(iri);
+        const uint32_t ns = intern_namespace(iri.substr(0, split));
+        const StringRef suffix = iri.substr(split);
+
+        NamespaceState &state = namespaces_[ns];
+        const std::size_t offset = chars_.size();
+        if (offset > std::numeric_limits<uint32_t>::max())
+            throw Exception("IriPool: more than 4 GiB of encoded IRIs");
+        if (entries_.size() >= npos)
+            throw Exception("IriPool: too many IRIs");
+        std::size_t shared = 0;
+        if (state.count % restart_interval_ != 0)
+        {
+            const std::size_t limit = std::min(suffix.size(), state.last_suffix.size());
+            while (shared < limit && suffix[shared] == state.last_suffix[shared])
+                ++shared;
+        }
+        put_varint(ns);
+        put_varint(shared);
+        if (shared)
+            put_varint(offset - state.last_offset);
+        put_varint(suffix.size() - shared);
+        chars_.insert(chars_.end(), suffix.data() + shared, suffix.data() + suffix.size());
+
+        state.last_suffix.assign(suffix.data(), suffix.size());
+        state.last_offset = offset;
+        state.count++;
+
+        const IriId id = static_cast<IriId>(entries_.size());
+        entries_.push_back(static_cast<uint32_t>(offset));
+        raw_bytes_ += iri.size();
+
+        slots_[slot] = id + 1;
+        if (entries_.size() * 10 > slots_.size() * 7)
+            grow();
+        return id;
+    }
+
+    IriId intern(const std::string &iri)
+    {
+        return intern(StringRef(iri));
+    }
+
+    /** Id of iri, or npos when it was not interned */
+    IriId find(StringRef iri) const
+    {
+        const std::size_t slot = find_slot(iri, hash_bytes(iri));
+        return slots_[slot] ? slots_[slot] - 1 : npos;
+    }
+
+    /** Append the IRI of id to out */
+    void append_to(IriId id, std::string &out) const
+    {
+        std::size_t offset = entries_[id];
+        out += namespaces_[get_varint(offset)].name;
+        decode_suffix(entries_[id], out);
+    }
+
+    std::string get(IriId id) const
+    {
+        std::string result;
+        append_to(id, result);
+        return result;
+    }
+
+    uint32_t namespace_id(IriId id) const
+    {
+        std::size_t offset = entries_[id];
+        return static_cast<uint32_t>(get_varint(offset));
+    }
+
+    const std::string & namespace_name(uint32_t ns) const { return namespaces_[ns].name; }
+
+private:
+
+    struct NamespaceState
+    {
+        std::string name;
+        std::string last_suffix;
+        std::size_t last_offset;
+        std::size_t count;
+    };
+
+    static std::size_t hash_bytes(StringRef s)
+    {
+        return NodeHash::hash_bytes(2166136261u, reinterpret_cast<const unsigned char *>(s.data()), s.size());
+    }
+
+    static std::size_t split_position(StringRef iri)
+    {
+        std::size_t i = iri.size();
+        while (i > 0 && iri[i - 1] != '/' && iri[i - 1] != '#' && iri[i - 1] != ':')
+            --i;
+        return i;
+    }
+
+    uint32_t intern_namespace(StringRef name)
+    {
+        const std::string key(name.data(), name.size());
+        std::unordered_map<std::string, uint32_t>::const_iterator it = namespace_ids_.find(key);
+        if (it != namespace_ids_.end())
+            return it->second;
+        NamespaceState state;
+        state.name = key;
+        state.last_offset = 0;
+        state.count = 0;
+        namespaces_.push_back(state);
+        const uint32_t ns = static_cast<uint32_t>(namespaces_.size() - 1);
+        namespace_ids_.insert(std::make_pair(key, ns));
+        return ns;
+    }
+
+    void put_varint(std::size_t value)
+    {
+        while (value >= 0x80)
+        {
+            chars_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        chars_.push_back(static_cast<char>(value));
+    }
+
+    std::size_t get_varint(std::size_t &offset) const
+    {
+        std::size_t value = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            const unsigned char c = static_cast<unsigned char>(chars_[offset++]);
+            value |= std::size_t(c & 0x7F) << shift;
+            if (!(c & 0x80))
+                return value;
+        }
+    }
+
+    /** Append suffix encoded at offset, following front coding links */
+    void decode_suffix(std::size_t offset, std::string &out) const
+    {
+        const std::size_t start = offset;
+        get_varint(offset);
+        const std::size_t shared = get_varint(offset);
+        if (shared)
+        {
+            const std::size_t back = get_varint(offset);
+            const std::size_t base = out.size();
+            decode_suffix(start - back, out);
+            out.resize(base + shared);
+        }
+        const std::size_t length = get_varint(offset);
+        out.append(chars_.data() + offset, length);
+    }
+
+    bool equals(IriId id, StringRef iri) const
+    {
+        const std::string &ns = namespaces_[namespace_id(id)].name;
+        if (iri.size() < ns.size() || iri.substr(0, ns.size()) != StringRef(ns))
+            return false;
+        scratch_.clear();
+        decode_suffix(entries_[id], scratch_);
+        return iri.substr(ns.size()) == StringRef(scratch_);
+    }
+
+    std::size_t find_slot(StringRef iri, std::size_t hash) const
+    {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t slot = hash & mask;
+        while (slots_[slot] && !equals(slots_[slot] - 1, iri))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    void grow()
+    {
+        std::vector<uint32_t> slots(slots_.size() * 2, 0);
+        const std::size_t mask = slots.size() - 1;
+        std::string iri;
+        for (IriId id = 0; id < entries_.size(); ++id)
+        {
+            iri.clear();
+            append_to(id, iri);
+            std::size_t slot = hash_bytes(iri) & mask;
+            while (slots[slot])
+                slot = (slot + 1) & mask;
+            slots[slot] = id + 1;
+        }
+        slots_.swap(slots);
+    }
+
+    unsigned restart_interval_;
+    std::size_t raw_bytes_;
+    std::vector<char> chars_;
+    // offset of the encoded namespace id and suffix of every IRI
+    std::vector<uint32_t> entries_;
+    std::vector<uint32_t> slots_;
+    std::vector<NamespaceState> namespaces_;
+    std::unordered_map<std::string, uint32_t> namespace_ids_;
+    mutable std::string scratch_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_IRI_POOL_HPP_INCLUDED */
@@ -0,0 +1,587 @@
+/*
+ * redland_loader.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_LOADER_HPP_INCLUDED
+#define RDW_LOADER_HPP_INCLUDED
+
+#include "redland.hpp"
+#include "redland_dedupe.hpp"
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Bounded lock-free ring buffer for exactly one producer thread
+ * and one consumer thread. Capacity is rounded up to a power of two.
+ */
+template <class T>
+class SPSCQueue
+{
+public:
+
+    explicit SPSCQueue(std::size_t capacity)
+        : head_(0)
+        , tail_(0)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue & operator=(const SPSCQueue &) = delete;
+
+    std::size_t capacity() const { return slots_.size(); }
+
+    /**
+     * Called by the producer only. Returns false when the queue is full,
+     * value is left untouched in that case.
+     */
+    bool try_push(T &value)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+            return false;
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Called by the consumer only. Returns false when the queue is empty.
+     */
+    bool try_pop(T &value)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> slots_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> head_;
+    alignas(64) std::atomic<std::size_t> tail_;
+};
+
+/**
+ * Batch of parsed statements in a thread neutral form: all term strings
+ * are copied into one flat buffer, no librdf or raptor objects are shared
+ * between the parser and the inserter.
+ */
+class StatementBatch
+{
+public:
+
+    struct Term
+    {
+        raptor_term_type type;
+        std::size_t value;
+        std::size_t value_length;
+        std::size_t datatype;
+        std::size_t datatype_length;
+        std::size_t language;
+        std::size_t language_length;
+    };
+
+    std::size_t size() const { return terms_.size() / 3; }
+
+    bool empty() const { return terms_.empty(); }
+
+    void clear()
+    {
+        buffer_.clear();
+        terms_.clear();
+    }
+
+    void add_statement(const raptor_statement *statement)
+    {
+        add_term(statement->subject);
+        add_term(statement->predicate);
+        add_term(statement->object);
+    }
+
+    const Term & term(std::size_t statement_index, int position) const
+    {
+        return terms_[statement_index * 3 + position];
+    }
+
+    const unsigned char * chars(std::size_t offset) const
+    {
+        return reinterpret_cast<const unsigned char *>(buffer_.data() + offset);
+    }
+
+private:
+
+    std::size_t append(const unsigned char *str, std::size_t length)
+    {
+        const std::size_t offset = buffer_.size();
+        if (str)
+            buffer_.insert(buffer_.end(), str, str + length);
+        buffer_.push_back('\0');
+        return offset;
+    }
+
+    void add_term(const raptor_term *term)
+    {
+        Term t;
+        std::memset(&t, 0, sizeof(t));
+        t.type = term->type;
+        switch (term->type)
+        {
+            case RAPTOR_TERM_TYPE_URI:
+            {
+                size_t length = 0;
+                const unsigned char *s = raptor_uri_as_counted_string(term->value.uri, &length);
+                t.value = append(s, length);
+                t.value_length = length;
+                break;
+            }
+            case RAPTOR_TERM_TYPE_LITERAL:
+            {
+                t.value = append(term->value.literal.string, term->value.literal.string_len);
+                t.value_length = term->value.literal.string_len;
+                if (term->value.literal.datatype)
+                {
+                    size_t length = 0;
+                    const unsigned char *s = raptor_uri_as_counted_string(term->value.literal.datatype, &length);
+                    t.datatype = append(s, length);
+                    t.datatype_length = length;
+                }
+                if (term->value.literal.language)
+                {
+                    t.language = append(term->value.literal.language, term->value.literal.language_len);
+                    t.language_length = term->value.literal.language_len;
+                }
+                break;
+            }
+            case RAPTOR_TERM_TYPE_BLANK:
+                t.value = append(term->value.blank.string, term->value.blank.string_len);
+                t.value_length = term->value.blank.string_len;
+                break;
+            default:
+                break;
+        }
+        terms_.push_back(t);
+    }
+
+    std::vector<char> buffer_;
+    std::vector<Term> terms_;
+};
+
+struct PipelinedLoaderStats
+{
+    std::size_t statements;
+    std::size_t batches;
+    /** Wall clock time of the whole load */
+    double elapsed_seconds;
+    /** Time the parser waited because the queue was full (backpressure) */
+    double parser_stall_seconds;
+    /** Time the inserter waited because the queue was empty */
+    double inserter_stall_seconds;
+
+    PipelinedLoaderStats()
+        : statements(0), batches(0), elapsed_seconds(0)
+        , parser_stall_seconds(0), inserter_stall_seconds(0)
+    { }
+};
+
+/**
+ * Two stage loader: a parser thread tokenizes the input with its own
+ * raptor world and pushes statement batches into a bounded SPSC queue,
+ * the calling thread drains the queue into the model in bulk. Only the
+ * calling thread touches the model and its world.
+ *
+ * The private raptor world numbers generated blank nodes from genid1 on
+ * every load, and labels from the input are only unique within a file.
+ * The inserter therefore renames every blank node label per load with a
+ * BlankNodeAllocator, so blank nodes of different loads into the same
+ * model never merge and are never taken as duplicates.
+ *
+ * An exception thrown while inserting is rethrown by the load after the
+ * parser thread finished, the statements of the batches read until then
+ * may be in the model.
+ */
+class PipelinedLoader
+{
+public:
+
+    PipelinedLoader(const World &world,
+                    Model &model,
+                    const char *syntax_name = "turtle",
+                    std::size_t batch_size = 1024,
+                    std::size_t queue_capacity = 64)
+        : world_(world)
+        , model_(model)
+        , syntax_name_(syntax_name ? syntax_name : "turtle")
+        , batch_size_(batch_size ? batch_size : 1)
+        , queue_capacity_(queue_capacity ? queue_capacity : 2)
+        , deduplicator_(0)
+    { }
+
+    PipelinedLoader(const PipelinedLoader &) = delete;
+    PipelinedLoader & operator=(const PipelinedLoader &) = delete;
+
+    const PipelinedLoaderStats & stats() const { return stats_; }
+
+    /**
+     * Drop certain duplicates before any librdf node is created for them.
+     * Pass 0 to disable, the deduplicator must outlive the loads.
+     */
+    void set_deduplicator(StatementDeduplicator *deduplicator)
+    {
+        deduplicator_ = deduplicator;
+    }
+
+    bool load_file(const char *filename, const char *base_uri = 0)
+    {
+        FILE *fd = fopen(filename, "rb");
+        if (!fd)
+            return false;
+        bool result;
+        if (base_uri)
+            result = load(fd, base_uri);
+        else
+        {
+            unsigned char *file_uri = raptor_uri_filename_to_uri_string(filename);
+            result = load(fd, reinterpret_cast<const char *>(file_uri));
+            raptor_free_memory(file_uri);
+        }
+        fclose(fd);
+        return result;
+    }
+
+    bool load(FILE *handle, const char *base_uri)
+    {
+        return run([handle](char *buf, std::size_t size) -> std::size_t
+            {
+                return fread(buf, 1, size, handle);
+            }, base_uri);
+    }
+
+    bool load(std::istream &in, const char *base_uri)
+    {
+        return run([&in](char *buf, std::size_t size) -> std::size_t
+            {
+                in.read(buf, size);
+                return static_cast<std::size_t>(in.gcount());
+            }, base_uri);
+    }
+
+private:
+
+    typedef std::unique_ptr<StatementBatch> BatchPtr;
+    typedef std::chrono::steady_clock Clock;
+
+    static double seconds_since(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    struct ParserContext
+    {
+        SPSCQueue<BatchPtr> &full;
+        SPSCQueue<BatchPtr> &empty;
+        std::size_t batch_size;
+        raptor_parser *parser;
+        BatchPtr current;
+        double stall_seconds;
+        bool failed;
+
+        ParserContext(SPSCQueue<BatchPtr> &full, SPSCQueue<BatchPtr> &empty, std::size_t batch_size)
+            : full(full), empty(empty), batch_size(batch_size), parser(0), stall_seconds(0), failed(false)
+        {
+            next_batch();
+        }
+
+        void next_batch()
+        {
+            if (!empty.try_pop(current) || !current)
+                current.reset(new StatementBatch());
+            current->clear();
+        }
+
+        void flush()
+        {
+            if (current->empty())
+                return;
+            if (!full.try_push(current))
+            {
+                const Clock::time_point start = Clock::now();
+                while (!full.try_push(current))
+                    std::this_thread::yield();
+                stall_seconds += seconds_since(start);
+            }
+            next_batch();
+        }
+
+        static void handle_statement(void *user_data, raptor_statement *statement)
+        {
+            ParserContext *ctx = static_cast<ParserContext *>(user_data);
+            // exceptions must not propagate through raptor's C frames
+            try
+            {
+                ctx->current->add_statement(statement);
+                if (ctx->current->size() >= ctx->batch_size)
+                    ctx->flush();
+            }
+            catch (...)
+            {
+                ctx->failed = true;
+                raptor_parser_parse_abort(ctx->parser);
+            }
+        }
+    };
+
+    template <class ReadFn>
+    bool run(ReadFn read, const char *base_uri)
+    {
+        stats_ = PipelinedLoaderStats();
+        blank_ids_.clear();
+        const Clock::time_point start = Clock::now();
+
+        SPSCQueue<BatchPtr> full(queue_capacity_);
+        SPSCQueue<BatchPtr> empty(queue_capacity_);
+        std::atomic<bool> done(false);
+        std::atomic<bool> parse_ok(true);
+        double parser_stall = 0;
+        std::vector<Statement> statements;
+        statements.reserve(batch_size_);
+
+        std::thread parser_thread([&]()
+        {
+            try
+            {
+                Raptor::World raptor_world;
+                ParserContext ctx(full, empty, batch_size_);
+                raptor_parser *parser = raptor_new_parser(raptor_world.c_obj(), syntax_name_.c_str());
+                if (!parser)
+                    throw AllocException("raptor_new_parser");
+                ctx.parser = parser;
+                raptor_parser_set_statement_handler(parser, &ctx, &ParserContext::handle_statement);
+
+                raptor_uri *base = base_uri ?
+                    raptor_new_uri(raptor_world.c_obj(), reinterpret_cast<const unsigned char *>(base_uri)) : 0;
+                bool ok = raptor_parser_parse_start(parser, base) == 0;
+
+                std::vector<char> chunk(64 * 1024);
+                while (ok && !ctx.failed)
+                {
+                    const std::size_t n = read(chunk.data(), chunk.size());
+                    const int is_end = n < chunk.size() ? 1 : 0;
+                    ok = raptor_parser_parse_chunk(parser, reinterpret_cast<const unsigned char *>(chunk.data()),
+                                                   n, is_end) == 0;
+                    if (is_end)
+                        break;
+                }
+                ctx.flush();
+
+                raptor_free_uri(base);
+                raptor_free_parser(parser);
+                parser_stall = ctx.stall_seconds;
+                parse_ok = ok && !ctx.failed;
+            }
+            catch (...)
+            {
+                parse_ok = false;
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        // the parser thread must be joined, so an insert error is kept until
+        // the queue is drained
+        bool insert_ok = true;
+        std::exception_ptr insert_error;
+        BatchPtr batch;
+
+        for (;;)
+        {
+            if (!full.try_pop(batch))
+            {
+                if (done.load(std::memory_order_acquire))
+                {
+                    // the parser may have pushed its last batch before setting done
+                    if (!full.try_pop(batch))
+                        break;
+                }
+                else
+                {
+                    const Clock::time_point stall_start = Clock::now();
+                    while (!full.try_pop(batch) && !done.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    stats_.inserter_stall_seconds += seconds_since(stall_start);
+                    if (!batch)
+                        continue;
+                }
+            }
+
+            if (insert_ok)
+            {
+                try
+                {
+                    insert_ok = insert_batch(*batch, statements);
+                }
+                catch (...)
+                {
+                    insert_ok = false;
+                    insert_error = std::current_exception();
+                }
+            }
+            stats_.statements += batch->size();
+            stats_.batches++;
+            empty.try_push(batch);
+            batch.reset();
+        }
+
+        parser_thread.join();
+        blank_ids_ = BlankIdMap();
+
+        stats_.parser_stall_seconds = parser_stall;
+        stats_.elapsed_seconds = seconds_since(start);
+        if (insert_error)
+            std::rethrow_exception(insert_error);
+        return parse_ok && insert_ok;
+    }
+
+    /** Label of the blank node term within the current load, written to buffer */
+    std::size_t blank_label(const StatementBatch &batch, const StatementBatch::Term &term, char *buffer)
+    {
+        blank_key_.assign(reinterpret_cast<const char *>(batch.chars(term.value)), term.value_length);
+        BlankIdMap::iterator it = blank_ids_.find(blank_key_);
+        if (it == blank_ids_.end())
+            it = blank_ids_.insert(std::make_pair(blank_key_, blank_nodes_.next_id())).first;
+        return blank_nodes_.format(it->second, buffer);
+    }
+
+    librdf_node * make_node(const StatementBatch &batch, const StatementBatch::Term &term,
+                            const char *label, std::size_t label_length)
+    {
+        switch (term.type)
+        {
+            case RAPTOR_TERM_TYPE_URI:
+                return librdf_new_node_from_counted_uri_string(world_.c_obj(),
+                    batch.chars(term.value), term.value_length);
+            case RAPTOR_TERM_TYPE_LITERAL:
+            {
+                librdf_uri *datatype = 0;
+                if (term.datatype_length)
+                {
+                    if (!datatype_.is_valid() || datatype_string_.compare(0, std::string::npos,
+                            reinterpret_cast<const char *>(batch.chars(term.datatype)), term.datatype_length) != 0)
+                    {
+                        datatype_string_.assign(reinterpret_cast<const char *>(batch.chars(term.datatype)),
+                                                term.datatype_length);
+                        datatype_ = Uri(world_, datatype_string_);
+                    }
+                    datatype = datatype_.c_obj();
+                }
+                return librdf_new_node_from_typed_counted_literal(world_.c_obj(),
+                    batch.chars(term.value), term.value_length,
+                    term.language_length ? reinterpret_cast<const char *>(batch.chars(term.language)) : 0,
+                    term.language_length, datatype);
+            }
+            case RAPTOR_TERM_TYPE_BLANK:
+                return librdf_new_node_from_counted_blank_identifier(world_.c_obj(),
+                    reinterpret_cast<const unsigned char *>(label), label_length);
+            default:
+                return 0;
+        }
+    }
+
+    static void add_fingerprint_term(FingerprintBuilder &builder, const StatementBatch &batch,
+                                     const StatementBatch::Term &term,
+                                     const char *label, std::size_t label_length)
+    {
+        switch (term.type)
+        {
+            case RAPTOR_TERM_TYPE_URI:
+                builder.add(FingerprintBuilder::URI_TAG, batch.chars(term.value), term.value_length);
+                break;
+            case RAPTOR_TERM_TYPE_LITERAL:
+                builder.add(FingerprintBuilder::LITERAL_TAG, batch.chars(term.value), term.value_length);
+                if (term.datatype_length)
+                    builder.add(FingerprintBuilder::DATATYPE_TAG, batch.chars(term.datatype), term.datatype_length);
+                if (term.language_length)
+                    builder.add(FingerprintBuilder::LANGUAGE_TAG, batch.chars(term.language), term.language_length);
+                break;
+            case RAPTOR_TERM_TYPE_BLANK:
+                builder.add(FingerprintBuilder::BLANK_TAG, reinterpret_cast<const unsigned char *>(label), label_length);
+                break;
+            default:
+                builder.add(FingerprintBuilder::NONE_TAG, 0, 0);
+                break;
+        }
+    }
+
+    bool insert_batch(const StatementBatch &batch, std::vector<Statement> &statements)
+    {
+        statements.clear();
+        char labels[3][BlankNodeAllocator::max_identifier_length];
+        std::size_t label_lengths[3];
+        for (std::size_t i = 0, n = batch.size(); i < n; ++i)
+        {
+            for (int position = 0; position < 3; ++position)
+            {
+                const StatementBatch::Term &term = batch.term(i, position);
+                label_lengths[position] = term.type == RAPTOR_TERM_TYPE_BLANK ?
+                    blank_label(batch, term, labels[position]) : 0;
+            }
+            if (deduplicator_)
+            {
+                FingerprintBuilder builder;
+                for (int position = 0; position < 3; ++position)
+                    add_fingerprint_term(builder, batch, batch.term(i, position),
+                                         labels[position], label_lengths[position]);
+                if (deduplicator_->test_and_insert(builder.finish()) == StatementDeduplicator::DUPLICATE)
+                    continue;
+            }
+            Node subject(make_node(batch, batch.term(i, 0), labels[0], label_lengths[0]));
+            Node predicate(make_node(batch, batch.term(i, 1), labels[1], label_lengths[1]));
+            Node object(make_node(batch, batch.term(i, 2), labels[2], label_lengths[2]));
+            if (!subject.is_valid() || !predicate.is_valid() || !object.is_valid())
+                return false;
+            statements.push_back(Statement(world_, std::move(subject), std::move(predicate), std::move(object)));
+        }
+        Stream stream(Stream::create_from(statements, world_));
+        return model_.add_statements(stream);
+    }
+
+    const World &world_;
+    Model &model_;
+    std::string syntax_name_;
+    std::size_t batch_size_;
+    std::size_t queue_capacity_;
+    PipelinedLoaderStats stats_;
+    typedef std::unordered_map<std::string, uint64_t> BlankIdMap;
+    BlankNodeAllocator blank_nodes_;
+    BlankIdMap blank_ids_;
+    std::string blank_key_;
+    Uri datatype_;
+    std::string datatype_string_;
+    StatementDeduplicator *deduplicator_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_LOADER_HPP_INCLUDED */
@@ -0,0 +1,59 @@
+/*
+ * redland_memory_tracker.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_MEMORY_TRACKER_HPP_INCLUDED
+#define RDW_MEMORY_TRACKER_HPP_INCLUDED
+
+#include "redland.hpp"
+#include "redland_model_listener.hpp"
+
+namespace Redland
+{
+
+/**
+ * Estimated memory of a model, kept up to date as statements are added
+ * and removed, so reading it is O(1). The estimate is the one of
+ * Model::memory_stats and covers the writes listed for ModelStats. A model
+ * can be tracked and have ModelStats attached at the same time.
+ */
+class MemoryTracker : public ModelListener
+{
+public:
+
+    explicit MemoryTracker(const MemoryLayout &layout = MemoryLayout())
+        : estimate_(layout)
+    { }
+
+    ~MemoryTracker()
+    {
+        detach();
+    }
+
+    const MemoryStats & stats() const { return estimate_.stats(); }
+
+    virtual void clear()
+    {
+        estimate_.clear();
+    }
+
+    virtual void statement_added(librdf_statement *statement)
+    {
+        estimate_.add(statement);
+    }
+
+    virtual void statement_removed(librdf_statement *statement)
+    {
+        estimate_.remove(statement);
+    }
+
+private:
+    MemoryEstimate estimate_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_MEMORY_TRACKER_HPP_INCLUDED */
@@ -0,0 +1,94 @@
+/*
+ * redland_model_listener.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_MODEL_LISTENER_HPP_INCLUDED
+#define RDW_MODEL_LISTENER_HPP_INCLUDED
+
+#include "redland.hpp"
+#include <unordered_set>
+
+namespace Redland
+{
+
+/**
+ * StatementListener keeping state derived from the statements of one
+ * model, like ModelStats and MemoryTracker. attach() scans the model once
+ * with rebuild() and then follows its changes. The listener follows the
+ * model when it is moved and is detached when it is destroyed.
+ */
+class ModelListener : public StatementListener
+{
+public:
+
+    ModelListener()
+        : model_(0)
+    { }
+
+    ModelListener(const ModelListener &) = delete;
+    ModelListener & operator=(const ModelListener &) = delete;
+
+    virtual ~ModelListener()
+    {
+        detach();
+    }
+
+    void attach(Model &model)
+    {
+        detach();
+        rebuild(model);
+        model.add_listener(this);
+        model_ = &model;
+    }
+
+    void detach()
+    {
+        Model *model = model_;
+        model_ = 0;
+        if (model)
+            model->remove_listener(this);
+    }
+
+    /** Model the listener is attached to, or 0 */
+    Model * model() const { return model_; }
+
+    /**
+     * Recompute the state from the statements of model: clear() followed by
+     * statement_added for every triple. Like the Model reports it, a triple
+     * stored in several contexts is added once.
+     */
+    void rebuild(const Model &model)
+    {
+        clear();
+        const bool contexts = model.supports_contexts();
+        std::unordered_set<Statement> seen;
+        Stream stream(model.as_stream());
+        for (; stream.is_valid() && !stream.is_end(); stream.next())
+        {
+            librdf_statement *statement = librdf_stream_get_object(stream.c_obj());
+            if (!statement)
+                continue;
+            if (contexts && !seen.insert(Statement(librdf_new_statement_from_statement(statement))).second)
+                continue;
+            statement_added(statement);
+        }
+    }
+
+    /** Reset the state to the one of an empty model */
+    virtual void clear() = 0;
+
+    virtual void model_relocated(Model *model)
+    {
+        model_ = model;
+    }
+
+private:
+    Model *model_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_MODEL_LISTENER_HPP_INCLUDED */
@@ -0,0 +1,275 @@
+/*
+ * redland_model_stats.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_MODEL_STATS_HPP_INCLUDED
+#define RDW_MODEL_STATS_HPP_INCLUDED
+
+#include "redland.hpp"
+#include "redland_model_listener.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * HyperLogLog sketch estimating the number of distinct hashes added, with
+ * a standard error of about 1.04 / sqrt(2^precision). The estimate is kept
+ * up to date on every add, so reading it is O(1).
+ */
+class HyperLogLog
+{
+public:
+
+    explicit HyperLogLog(unsigned precision = 12)
+        : precision_(precision < 4 ? 4 : precision > 18 ? 18 : precision)
+        , registers_(std::size_t(1) << precision_, 0)
+        , sum_(double(registers_.size()))
+        , num_zeros_(registers_.size())
+    { }
+
+    void add(uint64_t hash)
+    {
+        hash = mix(hash);
+        const std::size_t index = hash >> (64 - precision_);
+        const uint64_t rest = (hash << precision_) | (uint64_t(1) << (precision_ - 1));
+        uint8_t rank = 1;
+        for (uint64_t bit = uint64_t(1) << 63; !(rest & bit); bit >>= 1)
+            ++rank;
+
+        uint8_t &reg = registers_[index];
+        if (rank <= reg)
+            return;
+        if (reg == 0)
+            --num_zeros_;
+        sum_ += std::ldexp(1.0, -rank) - std::ldexp(1.0, -reg);
+        reg = rank;
+    }
+
+    double estimate() const
+    {
+        const double m = double(registers_.size());
+        const double alpha = 0.7213 / (1.0 + 1.079 / m);
+        const double raw = alpha * m * m / sum_;
+        // linear counting is more accurate for small cardinalities
+        if (raw <= 2.5 * m && num_zeros_ > 0)
+            return m * std::log(m / double(num_zeros_));
+        return raw;
+    }
+
+    void clear()
+    {
+        std::fill(registers_.begin(), registers_.end(), 0);
+        sum_ = double(registers_.size());
+        num_zeros_ = registers_.size();
+    }
+
+    std::size_t memory_usage() const { return registers_.capacity(); }
+
+private:
+
+    /** Finalizer of MurmurHash3, spreads FNV hashes over all bits */
+    static uint64_t mix(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    unsigned precision_;
+    std::vector<uint8_t> registers_;
+    double sum_;
+    std::size_t num_zeros_;
+};
+
+/**
+ * Live cardinality statistics of a model: number of statements, triples
+ * per predicate, instances per rdf:type class, and estimates of distinct
+ * subjects, objects and objects per predicate.
+ *
+ * Attach the statistics to a model to count all later changes made
+ * through Model::add_statement, add_statements and remove_statement,
+ * Parser::parse_into_model and PipelinedLoader. Writes made with librdf
+ * directly on Model::c_obj() are only counted when the storage reports
+ * them itself, like ColumnarStorage; call rebuild() after such writes on
+ * other storages. All queries are O(1).
+ * Exact counts follow removals. The distinct estimates are HyperLogLog
+ * sketches which can not forget values, so they only grow.
+ */
+class ModelStats : public ModelListener
+{
+public:
+
+    struct PredicateStats
+    {
+        Node predicate;
+        std::size_t count;
+        HyperLogLog distinct_objects;
+
+        PredicateStats(Node predicate, unsigned precision)
+            : predicate(std::move(predicate))
+            , count(0)
+            , distinct_objects(precision)
+        { }
+    };
+
+    struct ClassStats
+    {
+        Node type;
+        std::size_t count;
+
+        explicit ClassStats(Node type)
+            : type(std::move(type))
+            , count(0)
+        { }
+    };
+
+    typedef std::unordered_map<librdf_node *, PredicateStats, NodeHash, NodeEqual> PredicateMap;
+    typedef std::unordered_map<librdf_node *, ClassStats, NodeHash, NodeEqual> ClassMap;
+
+    /**
+     * precision is used for the model wide sketches, predicate_precision
+     * for the per predicate ones.
+     */
+    explicit ModelStats(unsigned precision = 14, unsigned predicate_precision = 10)
+        : predicate_precision_(predicate_precision)
+        , num_statements_(0)
+        , distinct_subjects_(precision)
+        , distinct_objects_(precision)
+    { }
+
+    ~ModelStats()
+    {
+        detach();
+    }
+
+    virtual void clear()
+    {
+        num_statements_ = 0;
+        predicates_.clear();
+        classes_.clear();
+        distinct_subjects_.clear();
+        distinct_objects_.clear();
+    }
+
+    std::size_t num_statements() const { return num_statements_; }
+
+    std::size_t num_predicates() const { return predicates_.size(); }
+
+    std::size_t num_classes() const { return classes_.size(); }
+
+    double distinct_subjects() const { return distinct_subjects_.estimate(); }
+
+    double distinct_objects() const { return distinct_objects_.estimate(); }
+
+    std::size_t predicate_count(const Node &predicate) const
+    {
+        PredicateMap::const_iterator it = predicates_.find(predicate.c_obj());
+        return it != predicates_.end() ? it->second.count : 0;
+    }
+
+    double distinct_objects(const Node &predicate) const
+    {
+        PredicateMap::const_iterator it = predicates_.find(predicate.c_obj());
+        return it != predicates_.end() ? it->second.distinct_objects.estimate() : 0.0;
+    }
+
+    /** Number of rdf:type statements with object type */
+    std::size_t class_count(const Node &type) const
+    {
+        ClassMap::const_iterator it = classes_.find(type.c_obj());
+        return it != classes_.end() ? it->second.count : 0;
+    }
+
+    const PredicateMap & predicates() const { return predicates_; }
+
+    const ClassMap & classes() const { return classes_; }
+
+    virtual void statement_added(librdf_statement *statement)
+    {
+        librdf_node *subject = librdf_statement_get_subject(statement);
+        librdf_node *predicate = librdf_statement_get_predicate(statement);
+        librdf_node *object = librdf_statement_get_object(statement);
+        NodeHash hash;
+        const std::size_t object_hash = hash(object);
+
+        num_statements_++;
+        distinct_subjects_.add(hash(subject));
+        distinct_objects_.add(object_hash);
+
+        PredicateMap::iterator it = predicates_.find(predicate);
+        if (it == predicates_.end())
+        {
+            Node key(librdf_new_node_from_node(predicate));
+            librdf_node *key_node = key.c_obj();
+            it = predicates_.insert(std::make_pair(key_node,
+                PredicateStats(std::move(key), predicate_precision_))).first;
+        }
+        it->second.count++;
+        it->second.distinct_objects.add(object_hash);
+
+        if (is_rdf_type(predicate))
+        {
+            ClassMap::iterator c = classes_.find(object);
+            if (c == classes_.end())
+            {
+                Node key(librdf_new_node_from_node(object));
+                librdf_node *key_node = key.c_obj();
+                c = classes_.insert(std::make_pair(key_node, ClassStats(std::move(key)))).first;
+            }
+            c->second.count++;
+        }
+    }
+
+    virtual void statement_removed(librdf_statement *statement)
+    {
+        librdf_node *predicate = librdf_statement_get_predicate(statement);
+        if (num_statements_)
+            num_statements_--;
+
+        PredicateMap::iterator it = predicates_.find(predicate);
+        if (it != predicates_.end() && --it->second.count == 0)
+            predicates_.erase(it);
+
+        if (is_rdf_type(predicate))
+        {
+            ClassMap::iterator c = classes_.find(librdf_statement_get_object(statement));
+            if (c != classes_.end() && --c->second.count == 0)
+                classes_.erase(c);
+        }
+    }
+
+private:
+
+    static bool is_rdf_type(librdf_node *predicate)
+    {
+        static const char rdf_type[] = "http://www.w3.org/1999/02/22-rdf-syntax-ns#type";
+        if (!predicate || !librdf_node_is_resource(predicate))
+            return false;
+        size_t length = 0;
+        const unsigned char *s = librdf_uri_as_counted_string(librdf_node_get_uri(predicate), &length);
+        return length == sizeof(rdf_type) - 1 && std::memcmp(s, rdf_type, length) == 0;
+    }
+
+    unsigned predicate_precision_;
+    std::size_t num_statements_;
+    HyperLogLog distinct_subjects_;
+    HyperLogLog distinct_objects_;
+    PredicateMap predicates_;
+    ClassMap classes_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_MODEL_STATS_HPP_INCLUDED */
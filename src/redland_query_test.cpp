@@ -0,0 +1,124 @@
+/*
+ * redland_query_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "redland.hpp"
+#include "Profiler.h"
+#include "test_check.hpp"
+
+#define EX(x) "http://example.org/" x
+
+using namespace Redland;
+
+/** Value of ?o in the only row of results, empty when there is none */
+static std::string single_object(QueryResults results)
+{
+    if (!results.is_valid() || results.is_finished())
+        return std::string();
+    const NodeView value = results.value("o");
+    const std::string object = value.is_valid() ? value.literal_value().to_string() : std::string();
+    results.next();
+    return results.is_finished() ? object : std::string();
+}
+
+int main(int argc, char *argv[])
+{
+    const int num_executions = argc > 1 ? atoi(argv[1]) : 1000;
+
+    World world;
+    Storage storage(world, "hashes", 0, "hash-type='memory'");
+    Model model(world, storage, 0);
+
+    const Node p(world, EX("p"));
+    for (int i = 0; i < 100; ++i)
+    {
+        const std::string id = std::to_string(i);
+        model.add_statement(Node(world, EX("s") + id), p, Node(world, id.c_str(), 0, false));
+    }
+
+    // results keep the query alive
+    QueryResults results;
+    {
+        Query query(world, "SELECT ?o WHERE { <" EX("s7") "> <" EX("p") "> ?o }");
+        results = query.execute(model);
+    }
+    CHECK(single_object(std::move(results)) == "7");
+
+    // two result sets of one query are read at the same time
+    {
+        Query query(world, "SELECT ?o WHERE { <" EX("s5") "> <" EX("p") "> ?o }");
+        QueryResults first = query.execute(model);
+        QueryResults second = query.execute(model);
+        CHECK(query.num_parsed() == 2);
+        CHECK(single_object(std::move(first)) == "5");
+        CHECK(single_object(std::move(second)) == "5");
+        CHECK(single_object(query.execute(model)) == "5");
+        CHECK(query.num_parsed() == 2);
+    }
+
+    // the default language accepts VALUES
+    {
+        Query query(world, "SELECT ?o WHERE { ?s <" EX("p") "> ?o } VALUES (?s) { (<" EX("s3") ">) }");
+        CHECK(single_object(query.execute(model)) == "3");
+    }
+
+    PreparedQuery prepared(world, "SELECT ?o WHERE { ?s <" EX("p") "> ?o }", "sparql11-query", 0, 2);
+    CHECK(prepared.bind("s", Node(world, EX("s1"))));
+    CHECK(single_object(prepared.execute(model)) == "1");
+    CHECK(prepared.bind("s", Node(world, EX("s2"))));
+    CHECK(single_object(prepared.execute(model)) == "2");
+    CHECK(prepared.bind("s", Node(world, EX("s1"))));
+    CHECK(single_object(prepared.execute(model)) == "1");
+    CHECK(prepared.num_parsed() == 2);
+
+    // s2 is the least recently used set and is evicted
+    CHECK(prepared.bind("s", Node(world, EX("s3"))));
+    CHECK(single_object(prepared.execute(model)) == "3");
+    CHECK(prepared.num_prepared() == 2);
+    CHECK(prepared.bind("s", Node(world, EX("s1"))));
+    CHECK(single_object(prepared.execute(model)) == "1");
+    CHECK(prepared.num_parsed() == 3);
+    CHECK(prepared.bind("s", Node(world, EX("s2"))));
+    CHECK(single_object(prepared.execute(model)) == "2");
+    CHECK(prepared.num_parsed() == 4);
+
+    // the cached query of s2 is still read by first, second gets its own
+    {
+        QueryResults first = prepared.execute(model);
+        QueryResults second = prepared.execute(model);
+        CHECK(prepared.num_parsed() == 5);
+        CHECK(single_object(std::move(first)) == "2");
+        CHECK(single_object(std::move(second)) == "2");
+    }
+
+    CHECK(!prepared.bind("s", Node::make_blank_node(world)));
+
+    // cost of a value set seen before and of a new one
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, recurring, changing;
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    for (int i = 0; i < num_executions; ++i)
+    {
+        prepared.bind("s", Node(world, EX("s1")));
+        single_object(prepared.execute(model));
+    }
+    recurring = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    for (int i = 0; i < num_executions; ++i)
+    {
+        prepared.bind("s", Node(world, EX("s") + std::to_string(i % 100)));
+        single_object(prepared.execute(model));
+    }
+    changing = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+    std::cout << num_executions << " executions with recurring values: " << recurring << " "
+              << MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS << ", with changing values: " << changing << " "
+              << MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS << std::endl;
+
+    return test_exit_status();
+}
@@ -0,0 +1,93 @@
+/*
+ * redland_shape.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_SHAPE_HPP_INCLUDED
+#define RDW_SHAPE_HPP_INCLUDED
+
+#include "redland.hpp"
+#include "rdf_shape.hpp"
+#include <cstdio>
+#include <limits>
+
+namespace Redland
+{
+
+/**
+ * RDFShape backend adding statements to a Model. Statements borrow the
+ * nodes of the emitter, values are written like Node::make_value_node.
+ */
+class ShapeBackend
+{
+public:
+    typedef librdf_node * node_type;
+
+    /**
+     * Blank nodes are numbered by blank_ids, whose tag keeps them apart
+     * from blank nodes of other runs.
+     */
+    ShapeBackend(const World &world, Model &model, BlankNodeIdSource &blank_ids = BlankNodeIdSource::global())
+        : world_(world)
+        , model_(model)
+        , statement_(world)
+        , xsd_double_(world, "http://www.w3.org/2001/XMLSchema#double")
+        , blank_nodes_(blank_ids)
+    { }
+
+    ShapeBackend(const ShapeBackend &) = delete;
+    ShapeBackend & operator=(const ShapeBackend &) = delete;
+
+    librdf_node * make_uri(const char *uri, std::size_t length)
+    {
+        librdf_node *node = librdf_new_node_from_counted_uri_string(world_.c_obj(),
+            reinterpret_cast<const unsigned char *>(uri), length);
+        if (!node)
+            throw AllocException("librdf_new_node_from_counted_uri_string");
+        return node;
+    }
+
+    librdf_node * make_blank()
+    {
+        return blank_nodes_.make_node(world_).release();
+    }
+
+    librdf_node * make_double(double value)
+    {
+        // same format as std::to_string
+        char buffer[std::numeric_limits<double>::max_exponent10 + 20];
+        const int length = std::snprintf(buffer, sizeof(buffer), "%f", value);
+        librdf_node *node = librdf_new_node_from_typed_counted_literal(world_.c_obj(),
+            reinterpret_cast<const unsigned char *>(buffer), length, NULL, 0, xsd_double_.c_obj());
+        if (!node)
+            throw AllocException("librdf_new_node_from_typed_counted_literal");
+        return node;
+    }
+
+    void free(librdf_node *node)
+    {
+        librdf_free_node(node);
+    }
+
+    bool add(librdf_node *subject, librdf_node *predicate, librdf_node *object)
+    {
+        statement_.set(subject, predicate, object);
+        return model_.add_statement(statement_);
+    }
+
+private:
+    const World &world_;
+    Model &model_;
+    StatementRef statement_;
+    Uri xsd_double_;
+    BlankNodeAllocator blank_nodes_;
+};
+
+template <class ShapeT>
+using ShapeEmitter = RDFShape::Emitter<ShapeT, ShapeBackend>;
+
+} // namespace Redland
+
+#endif /* RDW_SHAPE_HPP_INCLUDED */
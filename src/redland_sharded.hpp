@@ -0,0 +1,236 @@
+/*
+ * redland_sharded.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_SHARDED_HPP_INCLUDED
+#define RDW_SHARDED_HPP_INCLUDED
+
+#include "redland.hpp"
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Model partitioned by subject hash into N shards.
+ *
+ * librdf worlds are not thread safe, so every shard has its own World,
+ * Storage and Model and is only touched by one thread at a time. Nodes are
+ * copied by content into the shard's world on insert and back into the
+ * caller's world on query. Patterns with a bound subject go to one shard,
+ * all other patterns are run on all shards in parallel and merged.
+ */
+class ShardedModel
+{
+public:
+
+    ShardedModel(unsigned num_shards,
+                 const char *storage_name = "hashes",
+                 const char *options_string = "hash-type='memory'")
+    {
+        if (num_shards == 0)
+            num_shards = 1;
+        for (unsigned i = 0; i < num_shards; ++i)
+            shards_.push_back(std::unique_ptr<Shard>(new Shard(storage_name, options_string)));
+    }
+
+    ShardedModel(const ShardedModel &) = delete;
+    ShardedModel & operator=(const ShardedModel &) = delete;
+
+    std::size_t num_shards() const { return shards_.size(); }
+
+    /** Direct access to a shard, only from one thread at a time */
+    const World & shard_world(std::size_t i) const { return shards_[i]->world; }
+    Model & shard_model(std::size_t i) { return shards_[i]->model; }
+    const Model & shard_model(std::size_t i) const { return shards_[i]->model; }
+
+    std::size_t shard_of(librdf_node *subject) const
+    {
+        return NodeHash()(subject) % shards_.size();
+    }
+
+    std::size_t shard_of(const Node &subject) const
+    {
+        return shard_of(subject.c_obj());
+    }
+
+    bool add_statement(const Statement &statement)
+    {
+        Shard &shard = *shards_[shard_of(librdf_statement_get_subject(statement.c_obj()))];
+        return shard.model.add_statement(import_statement(shard.world, statement.c_obj()));
+    }
+
+    bool remove_statement(const Statement &statement)
+    {
+        Shard &shard = *shards_[shard_of(librdf_statement_get_subject(statement.c_obj()))];
+        return shard.model.remove_statement(import_statement(shard.world, statement.c_obj()));
+    }
+
+    /**
+     * Route statements to their shards and insert into all shards in
+     * parallel. Statements are only read by the worker threads.
+     */
+    bool add_statements(const std::vector<Statement> &statements)
+    {
+        std::vector<std::vector<std::size_t> > routed(shards_.size());
+        for (std::size_t i = 0; i < statements.size(); ++i)
+            routed[shard_of(librdf_statement_get_subject(statements[i].c_obj()))].push_back(i);
+
+        std::vector<char> ok(shards_.size(), 1);
+        run_on_shards([&](std::size_t s)
+            {
+                Shard &shard = *shards_[s];
+                for (std::vector<std::size_t>::const_iterator it = routed[s].begin(); it != routed[s].end(); ++it)
+                {
+                    if (!shard.model.add_statement(import_statement(shard.world, statements[*it].c_obj())))
+                        ok[s] = 0;
+                }
+            });
+        return std::find(ok.begin(), ok.end(), 0) == ok.end();
+    }
+
+    bool has_statement(const Statement &pattern) const
+    {
+        std::vector<Statement> found;
+        collect(pattern, found, 1);
+        return !found.empty();
+    }
+
+    /**
+     * Find statements matching pattern, copied into world.
+     */
+    template <class OutputIt>
+    OutputIt find_statements(const World &world, OutputIt first, const Statement &pattern) const
+    {
+        std::vector<Statement> found;
+        collect(pattern, found, 0);
+        // copying into the caller's world is done on this thread only
+        for (std::vector<Statement>::const_iterator it = found.begin(); it != found.end(); ++it)
+            *first++ = import_statement(world, it->c_obj());
+        return first;
+    }
+
+    /** Number of statements, or -1 when a storage can not tell */
+    int size() const
+    {
+        int total = 0;
+        for (std::size_t i = 0; i < shards_.size(); ++i)
+        {
+            const int n = librdf_model_size(shards_[i]->model.c_obj());
+            if (n < 0)
+                return -1;
+            total += n;
+        }
+        return total;
+    }
+
+private:
+
+    struct Shard
+    {
+        World world;
+        Storage storage;
+        Model model;
+
+        Shard(const char *storage_name, const char *options_string)
+            : world()
+            , storage(world, storage_name, "shard", options_string)
+            , model(world, storage, 0)
+        { }
+    };
+
+    static Node import_node(const World &world, librdf_node *node)
+    {
+        return node ? Node::make_from_raptor_term(world, node) : Node();
+    }
+
+    static Statement import_statement(const World &world, librdf_statement *statement)
+    {
+        return Statement(world,
+            import_node(world, librdf_statement_get_subject(statement)),
+            import_node(world, librdf_statement_get_predicate(statement)),
+            import_node(world, librdf_statement_get_object(statement)));
+    }
+
+    template <class Function>
+    void run_on_shards(Function function) const
+    {
+        if (shards_.size() == 1)
+        {
+            function(0);
+            return;
+        }
+        std::vector<std::exception_ptr> errors(shards_.size());
+        std::vector<std::thread> threads;
+        for (std::size_t s = 0; s < shards_.size(); ++s)
+        {
+            threads.push_back(std::thread([&function, &errors, s]()
+                {
+                    try
+                    {
+                        function(s);
+                    }
+                    catch (...)
+                    {
+                        errors[s] = std::current_exception();
+                    }
+                }));
+        }
+        for (std::size_t s = 0; s < threads.size(); ++s)
+            threads[s].join();
+        for (std::size_t s = 0; s < errors.size(); ++s)
+        {
+            if (errors[s])
+                std::rethrow_exception(errors[s]);
+        }
+    }
+
+    /**
+     * Collect matches from the owning shard or from all shards. Results are
+     * still objects of the shard worlds. limit 0 means no limit per shard.
+     */
+    void collect(const Statement &pattern, std::vector<Statement> &found, std::size_t limit) const
+    {
+        if (librdf_node *subject = librdf_statement_get_subject(pattern.c_obj()))
+        {
+            find_in_shard(*shards_[shard_of(subject)], pattern, found, limit);
+            return;
+        }
+
+        std::vector<std::vector<Statement> > partial(shards_.size());
+        run_on_shards([&](std::size_t s)
+            {
+                find_in_shard(*shards_[s], pattern, partial[s], limit);
+            });
+        for (std::size_t s = 0; s < partial.size(); ++s)
+        {
+            for (std::vector<Statement>::iterator it = partial[s].begin(); it != partial[s].end(); ++it)
+                found.push_back(std::move(*it));
+        }
+    }
+
+    static void find_in_shard(const Shard &shard, const Statement &pattern, std::vector<Statement> &found,
+                              std::size_t limit)
+    {
+        const Statement local(import_statement(shard.world, pattern.c_obj()));
+        if (limit)
+            shard.model.find_statements(std::back_inserter(found), limit, local);
+        else
+            shard.model.find_statements(std::back_inserter(found), local);
+    }
+
+    std::vector<std::unique_ptr<Shard> > shards_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_SHARDED_HPP_INCLUDED */
@@ -0,0 +1,461 @@
+/*
+ * redland_snapshot.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_SNAPSHOT_HPP_INCLUDED
+#define RDW_SNAPSHOT_HPP_INCLUDED
+
+#include "redland.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Immutable copy of the statements of a model.
+ *
+ * The snapshot owns all its data: a term dictionary and three sorted
+ * triple indices (SPO, POS, OSP), so every triple pattern is one
+ * contiguous range in one index. It holds no librdf objects, therefore
+ * any number of threads can query it without locking while the model it
+ * was built from keeps changing. Contexts are not kept.
+ */
+class ModelSnapshot
+{
+public:
+
+    typedef uint32_t TermId;
+
+    /** Wildcard in patterns, never a valid term id */
+    static const TermId ANY = 0;
+
+    struct Term
+    {
+        librdf_node_type type;
+        StringRef value;
+        StringRef datatype;
+        StringRef language;
+    };
+
+    struct Triple
+    {
+        TermId s;
+        TermId p;
+        TermId o;
+    };
+
+    typedef std::pair<const Triple *, const Triple *> Range;
+
+    /**
+     * Copy all statements of model. Must be called by the thread that
+     * owns the model's world.
+     */
+    explicit ModelSnapshot(const Model &model, bool parallel_sort = true)
+    {
+        // index 0 is reserved for ANY
+        terms_.push_back(TermData());
+
+        Stream stream(model.as_stream());
+        for (; stream.is_valid() && !stream.is_end(); stream.next())
+        {
+            librdf_statement *statement = librdf_stream_get_object(stream.c_obj());
+            if (!statement)
+                continue;
+            Triple triple;
+            triple.s = intern(librdf_statement_get_subject(statement));
+            triple.p = intern(librdf_statement_get_predicate(statement));
+            triple.o = intern(librdf_statement_get_object(statement));
+            spo_.push_back(triple);
+        }
+        build_indices(parallel_sort);
+    }
+
+    ModelSnapshot(const ModelSnapshot &) = delete;
+    ModelSnapshot & operator=(const ModelSnapshot &) = delete;
+
+    std::size_t size() const { return spo_.size(); }
+
+    std::size_t num_terms() const { return terms_.size() - 1; }
+
+    Term term(TermId id) const
+    {
+        const TermData &data = terms_[id];
+        Term term;
+        term.type = data.type;
+        term.value = StringRef(chars_.data() + data.value, data.value_length);
+        term.datatype = StringRef(chars_.data() + data.datatype, data.datatype_length);
+        term.language = StringRef(chars_.data() + data.language, data.language_length);
+        return term;
+    }
+
+    /** Id of the node's term or ANY when the snapshot does not contain it */
+    TermId lookup(librdf_node *node) const
+    {
+        if (!node)
+            return ANY;
+        std::unordered_map<std::string, TermId>::const_iterator it = ids_.find(make_key(node));
+        return it == ids_.end() ? ANY : it->second;
+    }
+
+    TermId lookup(const Node &node) const
+    {
+        return lookup(node.c_obj());
+    }
+
+    /**
+     * Triples matching the pattern, ANY matches every term.
+     */
+    Range find(TermId s, TermId p, TermId o) const
+    {
+        if (s != ANY)
+        {
+            if (p != ANY || o == ANY)
+                return equal_range(spo_, s, p, o, &ModelSnapshot::spo_key);
+            return equal_range(osp_, s, p, o, &ModelSnapshot::osp_key);
+        }
+        if (p != ANY)
+            return equal_range(pos_, s, p, o, &ModelSnapshot::pos_key);
+        if (o != ANY)
+            return equal_range(osp_, s, p, o, &ModelSnapshot::osp_key);
+        return Range(spo_.data(), spo_.data() + spo_.size());
+    }
+
+    /**
+     * Pattern given as statement with null nodes as wildcards. Bound nodes
+     * that are not in the snapshot match nothing.
+     */
+    Range find(const Statement &pattern) const
+    {
+        TermId ids[3];
+        librdf_node *nodes[3] = {
+            librdf_statement_get_subject(pattern.c_obj()),
+            librdf_statement_get_predicate(pattern.c_obj()),
+            librdf_statement_get_object(pattern.c_obj())
+        };
+        for (int i = 0; i < 3; ++i)
+        {
+            ids[i] = lookup(nodes[i]);
+            if (nodes[i] && ids[i] == ANY)
+                return Range();
+        }
+        return find(ids[0], ids[1], ids[2]);
+    }
+
+    /**
+     * Create librdf node for term in world, only from the world's thread.
+     */
+    Node make_node(const World &world, TermId id) const
+    {
+        const Term t = term(id);
+        const unsigned char *value = reinterpret_cast<const unsigned char *>(t.value.data());
+        librdf_node *node = 0;
+        switch (t.type)
+        {
+            case LIBRDF_NODE_TYPE_RESOURCE:
+                node = librdf_new_node_from_counted_uri_string(world.c_obj(), value, t.value.size());
+                break;
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                librdf_uri *datatype = 0;
+                if (!t.datatype.empty())
+                    datatype = librdf_new_uri2(world.c_obj(),
+                        reinterpret_cast<const unsigned char *>(t.datatype.data()), t.datatype.size());
+                node = librdf_new_node_from_typed_counted_literal(world.c_obj(), value, t.value.size(),
+                    t.language.empty() ? 0 : t.language.data(), t.language.size(), datatype);
+                librdf_free_uri(datatype);
+                break;
+            }
+            case LIBRDF_NODE_TYPE_BLANK:
+                node = librdf_new_node_from_counted_blank_identifier(world.c_obj(), value, t.value.size());
+                break;
+            default:
+                return Node();
+        }
+        if (!node)
+            throw AllocException("librdf_new_node");
+        return Node(node);
+    }
+
+    Statement make_statement(const World &world, const Triple &triple) const
+    {
+        return Statement(world, make_node(world, triple.s), make_node(world, triple.p), make_node(world, triple.o));
+    }
+
+private:
+
+    struct TermData
+    {
+        librdf_node_type type;
+        std::size_t value;
+        std::size_t value_length;
+        std::size_t datatype;
+        std::size_t datatype_length;
+        std::size_t language;
+        std::size_t language_length;
+
+        TermData()
+            : type(LIBRDF_NODE_TYPE_UNKNOWN)
+            , value(0), value_length(0)
+            , datatype(0), datatype_length(0)
+            , language(0), language_length(0)
+        { }
+    };
+
+    static void append_key_part(std::string &key, const void *data, std::size_t length)
+    {
+        key.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        key.append(static_cast<const char *>(data), length);
+    }
+
+    static std::string make_key(librdf_node *node)
+    {
+        std::string key;
+        const librdf_node_type type = librdf_node_get_type(node);
+        key.push_back(static_cast<char>(type));
+        size_t length = 0;
+        switch (type)
+        {
+            case LIBRDF_NODE_TYPE_RESOURCE:
+            {
+                const unsigned char *s = librdf_uri_as_counted_string(librdf_node_get_uri(node), &length);
+                append_key_part(key, s, length);
+                break;
+            }
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                const unsigned char *s = librdf_node_get_literal_value_as_counted_string(node, &length);
+                append_key_part(key, s, length);
+                length = 0;
+                s = 0;
+                if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                    s = librdf_uri_as_counted_string(datatype, &length);
+                append_key_part(key, s, length);
+                const char *language = librdf_node_get_literal_value_language(node);
+                append_key_part(key, language, language ? std::strlen(language) : 0);
+                break;
+            }
+            case LIBRDF_NODE_TYPE_BLANK:
+            {
+                const unsigned char *s = librdf_node_get_counted_blank_identifier(node, &length);
+                append_key_part(key, s, length);
+                break;
+            }
+            default:
+                break;
+        }
+        return key;
+    }
+
+    std::size_t append_chars(const void *data, std::size_t length)
+    {
+        const std::size_t offset = chars_.size();
+        chars_.insert(chars_.end(), static_cast<const char *>(data), static_cast<const char *>(data) + length);
+        return offset;
+    }
+
+    TermId intern(librdf_node *node)
+    {
+        std::string key(make_key(node));
+        std::unordered_map<std::string, TermId>::const_iterator it = ids_.find(key);
+        if (it != ids_.end())
+            return it->second;
+
+        TermData data;
+        data.type = librdf_node_get_type(node);
+        size_t length = 0;
+        switch (data.type)
+        {
+            case LIBRDF_NODE_TYPE_RESOURCE:
+            {
+                const unsigned char *s = librdf_uri_as_counted_string(librdf_node_get_uri(node), &length);
+                data.value = append_chars(s, length);
+                data.value_length = length;
+                break;
+            }
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                const unsigned char *s = librdf_node_get_literal_value_as_counted_string(node, &length);
+                data.value = append_chars(s, length);
+                data.value_length = length;
+                if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                {
+                    s = librdf_uri_as_counted_string(datatype, &length);
+                    data.datatype = append_chars(s, length);
+                    data.datatype_length = length;
+                }
+                if (const char *language = librdf_node_get_literal_value_language(node))
+                {
+                    data.language_length = std::strlen(language);
+                    data.language = append_chars(language, data.language_length);
+                }
+                break;
+            }
+            case LIBRDF_NODE_TYPE_BLANK:
+            {
+                const unsigned char *s = librdf_node_get_counted_blank_identifier(node, &length);
+                data.value = append_chars(s, length);
+                data.value_length = length;
+                break;
+            }
+            default:
+                break;
+        }
+
+        const TermId id = static_cast<TermId>(terms_.size());
+        terms_.push_back(data);
+        ids_.insert(std::make_pair(std::move(key), id));
+        return id;
+    }
+
+    struct SpoLess
+    {
+        bool operator()(const Triple &a, const Triple &b) const
+        {
+            return a.s != b.s ? a.s < b.s : a.p != b.p ? a.p < b.p : a.o < b.o;
+        }
+    };
+
+    struct PosLess
+    {
+        bool operator()(const Triple &a, const Triple &b) const
+        {
+            return a.p != b.p ? a.p < b.p : a.o != b.o ? a.o < b.o : a.s < b.s;
+        }
+    };
+
+    struct OspLess
+    {
+        bool operator()(const Triple &a, const Triple &b) const
+        {
+            return a.o != b.o ? a.o < b.o : a.s != b.s ? a.s < b.s : a.p < b.p;
+        }
+    };
+
+    void build_indices(bool parallel_sort)
+    {
+        pos_ = spo_;
+        osp_ = spo_;
+        if (parallel_sort && spo_.size() > 65536)
+        {
+            std::thread pos_thread([this]() { std::sort(pos_.begin(), pos_.end(), PosLess()); });
+            std::thread osp_thread([this]() { std::sort(osp_.begin(), osp_.end(), OspLess()); });
+            std::sort(spo_.begin(), spo_.end(), SpoLess());
+            pos_thread.join();
+            osp_thread.join();
+        }
+        else
+        {
+            std::sort(spo_.begin(), spo_.end(), SpoLess());
+            std::sort(pos_.begin(), pos_.end(), PosLess());
+            std::sort(osp_.begin(), osp_.end(), OspLess());
+        }
+    }
+
+    /**
+     * Index key of a triple reduced to the bound pattern positions, for
+     * SPO the key is (s, p, o) with trailing wildcards dropped and so on.
+     */
+    struct IndexKey
+    {
+        TermId first;
+        TermId second;
+        TermId third;
+        int bound;
+    };
+
+    static IndexKey spo_key(const Triple &t) { IndexKey k = { t.s, t.p, t.o, 3 }; return k; }
+    static IndexKey pos_key(const Triple &t) { IndexKey k = { t.p, t.o, t.s, 3 }; return k; }
+    static IndexKey osp_key(const Triple &t) { IndexKey k = { t.o, t.s, t.p, 3 }; return k; }
+
+    static Range equal_range(const std::vector<Triple> &index, TermId s, TermId p, TermId o,
+                             IndexKey (*key_of)(const Triple &))
+    {
+        Triple pattern = { s, p, o };
+        IndexKey key = key_of(pattern);
+        key.bound = key.third != ANY ? 3 : key.second != ANY ? 2 : 1;
+
+        struct Compare
+        {
+            IndexKey (*key_of)(const Triple &);
+            int bound;
+
+            static int compare(const IndexKey &a, const IndexKey &b, int bound)
+            {
+                if (a.first != b.first)
+                    return a.first < b.first ? -1 : 1;
+                if (bound > 1 && a.second != b.second)
+                    return a.second < b.second ? -1 : 1;
+                if (bound > 2 && a.third != b.third)
+                    return a.third < b.third ? -1 : 1;
+                return 0;
+            }
+            bool operator()(const Triple &t, const IndexKey &k) const { return compare(key_of(t), k, bound) < 0; }
+            bool operator()(const IndexKey &k, const Triple &t) const { return compare(k, key_of(t), bound) < 0; }
+        };
+
+        Compare compare = { key_of, key.bound };
+        std::pair<std::vector<Triple>::const_iterator, std::vector<Triple>::const_iterator> range =
+            std::equal_range(index.begin(), index.end(), key, compare);
+        const Triple *base = index.data();
+        return Range(base + (range.first - index.begin()), base + (range.second - index.begin()));
+    }
+
+    std::vector<char> chars_;
+    std::vector<TermData> terms_;
+    std::unordered_map<std::string, TermId> ids_;
+    std::vector<Triple> spo_;
+    std::vector<Triple> pos_;
+    std::vector<Triple> osp_;
+};
+
+/**
+ * Holder for the current snapshot of a model. Readers get the snapshot
+ * with an atomic shared_ptr load and keep it alive while they use it,
+ * the writer thread republishes a new snapshot whenever it wants.
+ */
+class SnapshotPublisher
+{
+public:
+
+    typedef std::shared_ptr<const ModelSnapshot> SnapshotPtr;
+
+    SnapshotPublisher() { }
+
+    SnapshotPublisher(const SnapshotPublisher &) = delete;
+    SnapshotPublisher & operator=(const SnapshotPublisher &) = delete;
+
+    /** Current snapshot, may be null before the first publish. Any thread. */
+    SnapshotPtr get() const
+    {
+        return std::atomic_load(&current_);
+    }
+
+    void publish(SnapshotPtr snapshot)
+    {
+        std::atomic_store(&current_, std::move(snapshot));
+    }
+
+    /** Freeze model and publish it, only from the model's thread */
+    SnapshotPtr refresh(const Model &model)
+    {
+        SnapshotPtr snapshot(new ModelSnapshot(model));
+        publish(snapshot);
+        return snapshot;
+    }
+
+private:
+    SnapshotPtr current_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_SNAPSHOT_HPP_INCLUDED */
@@ -14,6 +14,8 @@
 
 #define REDLAND_LIB
 #include "redland.hpp"
+#include "redland_shape.hpp"
+#include "pose_shape.hpp"
 #include "Profiler.h"
 
 #define RDF(x) "http://www.w3.org/1999/02/22-rdf-syntax-ns#" x
@@ -28,12 +30,6 @@
 #define NEW_LITERAL_NODE(world, literal_str) librdf_new_node_from_literal(world, (const unsigned char *)literal_str, NULL, 0)
 #define NEW_BLANK_NODE(world) librdf_new_node_from_blank_identifier(world, NULL)
 
-inline Redland::Node double_node(const Redland::World &world, double value)
-{
-    Redland::Uri xsd_double(world, "http://www.w3.org/2001/XMLSchema#double");
-    return Redland::Node::make_typed_literal_node(world, std::to_string(value), xsd_double);
-}
-
 int main(int argc, char *argv[])
 {
     using namespace Redland;
@@ -65,161 +61,15 @@ int main(int argc, char *argv[])
 
     MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, finish, elapsed;
 
+    // constant nodes of the pose are created once by the emitter
+    ShapeEmitter<PoseShape::Pose> pose_emitter(world, model);
+    const double values[PoseShape::NUM_VALUES] = { 1, 2, 3, 1, 1, 1, 1 };
+
     start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
 
     for (int i = 0; i < num; ++i)
     {
-        const std::string uuid_url = "http://test.arvida.de/UUID" + std::to_string(i);
-
-        model.add_statement(
-            world,
-            Redland::Node::make_uri_node(world, uuid_url),
-            Redland::Node::make_uri_node(world, RDF("type")),
-            Redland::Node::make_uri_node(world, SPATIAL("SpatialRelationship")));
-
-        {
-            Node n1 = Redland::Node::make_blank_node(world);
-
-            model.add_statement(
-                world,
-                Redland::Node::make_uri_node(world, uuid_url),
-                Redland::Node::make_uri_node(world, SPATIAL("sourceCoordinateSystem")),
-                n1);
-
-            model.add_statement(
-                world,
-                n1,
-                Redland::Node::make_uri_node(world, RDF("type")),
-                Redland::Node::make_uri_node(world, MATHS("LeftHandedCartesianCoordinateSystem3D")));
-        }
-
-        {
-            Node n1 = Redland::Node::make_blank_node(world);
-
-            model.add_statement(
-                world,
-                Redland::Node::make_uri_node(world, uuid_url),
-                Redland::Node::make_uri_node(world, SPATIAL("targetCoordinateSystem")),
-                n1);
-
-            model.add_statement(
-                world,
-                n1,
-                Redland::Node::make_uri_node(world, RDF("type")),
-                Redland::Node::make_uri_node(world, MATHS("RightHandedCartesianCoordinateSystem2D")));
-        }
-
-        Redland::Uri xsd_double(world, XSD("double"));
-
-        {
-
-            // translation
-            Node n1 = Redland::Node::make_blank_node(world);
-            Node n2 = Redland::Node::make_blank_node(world);
-
-            model.add_statement(
-                world,
-                Redland::Node::make_uri_node(world, uuid_url),
-                Redland::Node::make_uri_node(world, SPATIAL("translation")),
-                n1);
-
-            model.add_statement(
-                world,
-                n1,
-                Redland::Node::make_uri_node(world, RDF("type")),
-                Redland::Node::make_uri_node(world, SPATIAL("Translation3D")));
-
-            model.add_statement(
-                world,
-                n1,
-                Redland::Node::make_uri_node(world, VOM("quantityValue")),
-                n2);
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, RDF("type")),
-                Redland::Node::make_uri_node(world, MATHS("Vector3D")));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, MATHS("x")),
-                double_node(world, 1));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, MATHS("y")),
-                double_node(world, 2));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, MATHS("z")),
-                double_node(world, 3));
-        }
-
-        {
-            // rotation
-
-            Node n1 = Redland::Node::make_blank_node(world);
-            Node n2 = Redland::Node::make_blank_node(world);
-
-            model.add_statement(
-                world,
-                Redland::Node::make_uri_node(world, uuid_url),
-                Redland::Node::make_uri_node(world, SPATIAL("rotation")),
-                n1);
-
-            model.add_statement(
-                world,
-                n1,
-                Redland::Node::make_uri_node(world, RDF("type")),
-                Redland::Node::make_uri_node(world, SPATIAL("Rotation3D")));
-
-            model.add_statement(
-                world,
-                n1,
-                Redland::Node::make_uri_node(world, VOM("quantityValue")),
-                n2);
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, RDF("type")),
-                Redland::Node::make_uri_node(world, MATHS("Quaternion")));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, RDF("type")),
-                Redland::Node::make_uri_node(world, MATHS("Vector4D")));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, MATHS("x")),
-                double_node(world, 1));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, MATHS("y")),
-                double_node(world, 1));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, MATHS("z")),
-                double_node(world, 1));
-
-            model.add_statement(
-                world,
-                n2,
-                Redland::Node::make_uri_node(world, MATHS("w")),
-                double_node(world, 1));
-        }
+        pose_emitter.emit("http://test.arvida.de/UUID" + std::to_string(i), values);
     }
 
     finish = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
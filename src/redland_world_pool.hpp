@@ -0,0 +1,135 @@
+/*
+ * redland_world_pool.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_WORLD_POOL_HPP_INCLUDED
+#define RDW_WORLD_POOL_HPP_INCLUDED
+
+#include "redland.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Pool of opened worlds for short-lived tasks.
+ *
+ * librdf_world_open initializes all parser, serializer, storage and query
+ * factories, which dominates the cost of a World. The pool keeps opened
+ * worlds around and hands them out one task at a time, so the cost is
+ * paid once per pooled world instead of once per task. A world is only
+ * used by the thread holding its lease. Objects created in a world must
+ * be freed before the lease is released.
+ */
+class WorldPool
+{
+public:
+
+    class Lease
+    {
+    public:
+
+        Lease(Lease && other)
+            : pool_(other.pool_)
+            , world_(std::move(other.world_))
+        {
+            other.pool_ = 0;
+        }
+
+        Lease(const Lease &) = delete;
+        Lease & operator=(const Lease &) = delete;
+
+        ~Lease()
+        {
+            if (pool_ && world_)
+                pool_->release(std::move(world_));
+        }
+
+        World & world() { return *world_; }
+        World & operator*() { return *world_; }
+        World * operator->() { return world_.get(); }
+
+    private:
+        friend class WorldPool;
+
+        Lease(WorldPool *pool, std::unique_ptr<World> world)
+            : pool_(pool)
+            , world_(std::move(world))
+        { }
+
+        WorldPool *pool_;
+        std::unique_ptr<World> world_;
+    };
+
+    /**
+     * Open initial_size worlds now, keep at most max_idle returned worlds.
+     */
+    explicit WorldPool(std::size_t initial_size = 0, std::size_t max_idle = 16)
+        : max_idle_(max_idle)
+    {
+        reserve(initial_size);
+    }
+
+    WorldPool(const WorldPool &) = delete;
+    WorldPool & operator=(const WorldPool &) = delete;
+
+    /** Idle world from the pool, or a newly opened one when it is empty */
+    Lease acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty())
+            {
+                std::unique_ptr<World> world(std::move(idle_.back()));
+                idle_.pop_back();
+                return Lease(this, std::move(world));
+            }
+        }
+        return Lease(this, std::unique_ptr<World>(new World()));
+    }
+
+    /** Open worlds until n are idle, worlds are opened outside the lock */
+    void reserve(std::size_t n)
+    {
+        for (;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (idle_.size() >= n)
+                    return;
+            }
+            std::unique_ptr<World> world(new World());
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.push_back(std::move(world));
+        }
+    }
+
+    std::size_t num_idle() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return idle_.size();
+    }
+
+private:
+
+    void release(std::unique_ptr<World> world)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() < max_idle_)
+            idle_.push_back(std::move(world));
+        // otherwise the world is freed with the parameter, after unlocking
+    }
+
+    std::size_t max_idle_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<World> > idle_;
+};
+
+} // namespace Redland
+
+#endif /* RDW_WORLD_POOL_HPP_INCLUDED */
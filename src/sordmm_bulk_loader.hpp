@@ -0,0 +1,266 @@
+/*
+ * sordmm_bulk_loader.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef SORDMM_BULK_LOADER_HPP_INCLUDED
+#define SORDMM_BULK_LOADER_HPP_INCLUDED
+
+#include "sord/sordmm.hpp"
+#include "serd/serd.h"
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace Sord
+{
+
+/**
+ * Bulk loader for Sord models.
+ *
+ * Model::load_file inserts every quad into the model indices in arrival
+ * order. BulkLoader reads the whole input with serd callbacks into a flat
+ * quad buffer, sorts it in parallel in the order of the model's primary
+ * (S, P, O, G) index, drops duplicates and only then adds the quads, so
+ * the index trees are filled front to back. Like Sord's indices, quads are
+ * ordered by their interned node pointers, not by the node strings.
+ */
+class BulkLoader
+{
+public:
+
+    struct Quad
+    {
+        SordNode *nodes[4];
+    };
+
+    explicit BulkLoader(Model &model, unsigned num_threads = std::thread::hardware_concurrency())
+        : model_(model)
+        , env_(0)
+        , num_threads_(num_threads ? num_threads : 1)
+        , num_read_(0)
+    { }
+
+    BulkLoader(const BulkLoader &) = delete;
+    BulkLoader & operator=(const BulkLoader &) = delete;
+
+    ~BulkLoader()
+    {
+        clear();
+    }
+
+    /** Number of quads read by the last load, including duplicates */
+    std::size_t num_read() const { return num_read_; }
+
+    /**
+     * Load file into the model, same arguments as Model::load_file.
+     */
+    bool load_file(SerdEnv *env, SerdSyntax syntax, const std::string &file_name, const std::string &base_uri = "")
+    {
+        clear();
+        env_ = env;
+        num_read_ = 0;
+
+        if (!base_uri.empty())
+        {
+            const SerdNode base = serd_node_from_string(SERD_URI, (const uint8_t *)base_uri.c_str());
+            serd_env_set_base_uri(env_, &base);
+        }
+
+        SerdReader *reader = serd_reader_new(syntax, this, NULL,
+                                             &BulkLoader::on_base, &BulkLoader::on_prefix,
+                                             &BulkLoader::on_statement, NULL);
+        if (!reader)
+            return false;
+        const SerdStatus status = serd_reader_read_file(reader, (const uint8_t *)file_name.c_str());
+        serd_reader_free(reader);
+
+        num_read_ = quads_.size();
+        sort_quads();
+        insert_quads();
+        clear();
+        return status == SERD_SUCCESS;
+    }
+
+private:
+
+    /** Order of Sord's indices, which compare interned nodes by address */
+    struct QuadLess
+    {
+        bool operator()(const Quad &a, const Quad &b) const
+        {
+            return std::lexicographical_compare(a.nodes, a.nodes + 4, b.nodes, b.nodes + 4,
+                                                std::less<const SordNode *>());
+        }
+    };
+
+    /**
+     * Sample sort: quads are distributed into one bucket per thread by
+     * sampled splitters and the buckets are sorted independently, so no
+     * merge pass over the whole buffer is needed.
+     */
+    void sort_quads()
+    {
+        const std::size_t n = quads_.size();
+        std::size_t parts = num_threads_;
+        // not worth spawning threads for small inputs
+        while (parts > 1 && n / parts < 16384)
+            parts >>= 1;
+
+        if (parts <= 1)
+        {
+            std::sort(quads_.begin(), quads_.end(), QuadLess());
+            return;
+        }
+
+        const std::size_t oversampling = 64;
+        std::vector<Quad> sample;
+        for (std::size_t i = 0; i < parts * oversampling; ++i)
+            sample.push_back(quads_[n * i / (parts * oversampling)]);
+        std::sort(sample.begin(), sample.end(), QuadLess());
+        std::vector<Quad> splitters;
+        for (std::size_t i = 1; i < parts; ++i)
+            splitters.push_back(sample[i * oversampling]);
+
+        std::vector<unsigned> bucket_of(n);
+        std::vector<std::size_t> bounds(parts + 1, 0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            bucket_of[i] = static_cast<unsigned>(
+                std::upper_bound(splitters.begin(), splitters.end(), quads_[i], QuadLess()) - splitters.begin());
+            ++bounds[bucket_of[i] + 1];
+        }
+        for (std::size_t i = 0; i < parts; ++i)
+            bounds[i + 1] += bounds[i];
+
+        std::vector<Quad> sorted(n);
+        std::vector<std::size_t> next(bounds.begin(), bounds.end() - 1);
+        for (std::size_t i = 0; i < n; ++i)
+            sorted[next[bucket_of[i]]++] = quads_[i];
+
+        std::vector<std::thread> threads;
+        threads.reserve(parts);
+        std::size_t part = 0;
+        for (; part < parts; ++part)
+        {
+            std::vector<Quad>::iterator first = sorted.begin() + bounds[part];
+            std::vector<Quad>::iterator last = sorted.begin() + bounds[part + 1];
+            try
+            {
+                threads.push_back(std::thread([first, last]() { std::sort(first, last, QuadLess()); }));
+            }
+            catch (const std::system_error &)
+            {
+                // no thread available, sort the remaining buckets here
+                break;
+            }
+        }
+        for (; part < parts; ++part)
+            std::sort(sorted.begin() + bounds[part], sorted.begin() + bounds[part + 1], QuadLess());
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+        quads_.swap(sorted);
+    }
+
+    void insert_quads()
+    {
+        SordModel *model = model_.c_obj();
+        const Quad *prev = 0;
+        for (std::vector<Quad>::const_iterator it = quads_.begin(), et = quads_.end(); it != et; ++it)
+        {
+            // nodes are interned by the world, equal quads have equal pointers
+            if (prev && std::equal(prev->nodes, prev->nodes + 4, it->nodes))
+                continue;
+            SordQuad quad = { it->nodes[0], it->nodes[1], it->nodes[2], it->nodes[3] };
+            sord_add(model, quad);
+            prev = &*it;
+        }
+    }
+
+    void clear()
+    {
+        SordWorld *world = model_.world().c_obj();
+        for (std::vector<Quad>::iterator it = quads_.begin(), et = quads_.end(); it != et; ++it)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                if (it->nodes[i])
+                    sord_node_free(world, it->nodes[i]);
+            }
+        }
+        quads_.clear();
+    }
+
+    static SerdStatus on_base(void *handle, const SerdNode *uri)
+    {
+        BulkLoader *loader = static_cast<BulkLoader *>(handle);
+        return serd_env_set_base_uri(loader->env_, uri);
+    }
+
+    static SerdStatus on_prefix(void *handle, const SerdNode *name, const SerdNode *uri)
+    {
+        BulkLoader *loader = static_cast<BulkLoader *>(handle);
+        return serd_env_set_prefix(loader->env_, name, uri);
+    }
+
+    static SerdStatus on_statement(void *handle,
+                                   SerdStatementFlags flags,
+                                   const SerdNode *graph,
+                                   const SerdNode *subject,
+                                   const SerdNode *predicate,
+                                   const SerdNode *object,
+                                   const SerdNode *object_datatype,
+                                   const SerdNode *object_lang)
+    {
+        BulkLoader *loader = static_cast<BulkLoader *>(handle);
+        SordWorld *world = loader->model_.world().c_obj();
+        SerdEnv *env = loader->env_;
+
+        Quad quad;
+        quad.nodes[0] = sord_node_from_serd_node(world, env, subject, NULL, NULL);
+        quad.nodes[1] = sord_node_from_serd_node(world, env, predicate, NULL, NULL);
+        quad.nodes[2] = sord_node_from_serd_node(world, env, object, object_datatype, object_lang);
+        quad.nodes[3] = graph ? sord_node_from_serd_node(world, env, graph, NULL, NULL) : NULL;
+
+        if (!quad.nodes[0] || !quad.nodes[1] || !quad.nodes[2])
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                if (quad.nodes[i])
+                    sord_node_free(world, quad.nodes[i]);
+            }
+            return SERD_ERR_UNKNOWN;
+        }
+
+        // exceptions must not propagate through serd's C frames
+        try
+        {
+            loader->quads_.push_back(quad);
+        }
+        catch (...)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                if (quad.nodes[i])
+                    sord_node_free(world, quad.nodes[i]);
+            }
+            return SERD_ERR_UNKNOWN;
+        }
+        return SERD_SUCCESS;
+    }
+
+    Model &model_;
+    SerdEnv *env_;
+    unsigned num_threads_;
+    std::size_t num_read_;
+    std::vector<Quad> quads_;
+};
+
+} // namespace Sord
+
+#endif /* SORDMM_BULK_LOADER_HPP_INCLUDED */
@@ -0,0 +1,109 @@
+/*
+ * sordmm_memory_stats.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef SORDMM_MEMORY_STATS_HPP_INCLUDED
+#define SORDMM_MEMORY_STATS_HPP_INCLUDED
+
+#include "sord/sordmm.hpp"
+#include <cstring>
+#include <unordered_set>
+
+namespace Sord
+{
+
+/**
+ * Memory used by a Sord model, in bytes. Same fields as
+ * Redland::MemoryStats so both stores can be exported side by side.
+ */
+struct MemoryStats
+{
+    std::size_t num_statements;
+    std::size_t num_nodes;
+    std::size_t num_literals;
+    std::size_t node_bytes;
+    std::size_t literal_bytes;
+    std::size_t statement_bytes;
+    std::size_t index_bytes;
+
+    MemoryStats()
+        : num_statements(0), num_nodes(0), num_literals(0)
+        , node_bytes(0), literal_bytes(0), statement_bytes(0), index_bytes(0)
+    { }
+
+    std::size_t total_bytes() const
+    {
+        return node_bytes + literal_bytes + statement_bytes + index_bytes;
+    }
+
+    double bytes_per_triple() const
+    {
+        return num_statements ? double(total_bytes()) / num_statements : 0.0;
+    }
+};
+
+/**
+ * Estimate memory used by model with one scan over its quads.
+ *
+ * Sord interns nodes in the world, so nodes are counted once by address.
+ * Every quad is one array of 4 node pointers, and every index is a B-tree
+ * holding one pointer per quad. Sord does not report which indices a model
+ * has, so pass the indices and graphs arguments used to create it.
+ */
+inline MemoryStats memory_stats(Model &model, unsigned indices = (SORD_SPO|SORD_OPS), bool graphs = true)
+{
+    // SordNode: SerdNode, reference count and meta pointer, plus a world hash slot
+    static const std::size_t node_overhead = 8 * sizeof(void *);
+    // B-tree pages are about two thirds full
+    static const std::size_t index_entry_bytes = sizeof(void *) * 3 / 2;
+
+    unsigned num_indexes = 0;
+    for (unsigned bits = indices | SORD_SPO; bits; bits &= bits - 1)
+        num_indexes++;
+    if (graphs)
+        num_indexes *= 2;
+
+    MemoryStats stats;
+    std::unordered_set<const SordNode *> seen;
+    SordIter *iter = sord_begin(model.c_obj());
+    for (; iter && !sord_iter_end(iter); sord_iter_next(iter))
+    {
+        SordQuad quad;
+        sord_iter_get(iter, quad);
+        stats.num_statements++;
+        for (int i = 0; i < 4; ++i)
+        {
+            const SordNode *node = quad[i];
+            if (!node || !seen.insert(node).second)
+                continue;
+            size_t length = 0;
+            sord_node_get_string_counted(node, &length);
+            const std::size_t bytes = node_overhead + length + 1;
+            if (sord_node_get_type(node) == SORD_LITERAL)
+            {
+                stats.num_literals++;
+                stats.literal_bytes += bytes;
+                // datatypes are separate nodes, languages are interned
+                if (const char *language = sord_node_get_language(node))
+                    stats.literal_bytes += std::strlen(language) + 1;
+            }
+            else
+            {
+                stats.num_nodes++;
+                stats.node_bytes += bytes;
+            }
+        }
+    }
+    sord_iter_free(iter);
+
+    stats.statement_bytes = stats.num_statements * sizeof(SordQuad);
+    stats.index_bytes = stats.num_statements * num_indexes * index_entry_bytes;
+    return stats;
+}
+
+} // namespace Sord
+
+#endif /* SORDMM_MEMORY_STATS_HPP_INCLUDED */
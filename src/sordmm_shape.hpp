@@ -0,0 +1,111 @@
+/*
+ * sordmm_shape.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef SORDMM_SHAPE_HPP_INCLUDED
+#define SORDMM_SHAPE_HPP_INCLUDED
+
+#include "sord/sordmm.hpp"
+#include "serd/serd.h"
+#include "rdf_shape.hpp"
+#include "blank_tag.hpp"
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+namespace Sord
+{
+
+/**
+ * RDFShape backend adding quads to a Model. Values are written like
+ * serd_node_new_decimal(value, 7). Node constructors throw
+ * std::runtime_error when Sord returns no node.
+ */
+class ShapeBackend
+{
+public:
+    typedef SordNode * node_type;
+
+    /**
+     * Blank nodes are named prefix, a random per process tag and a process
+     * wide counter. The tag keeps them apart from blank nodes written by
+     * other runs, the prefix must differ from the one used with
+     * Node::blank_id.
+     */
+    ShapeBackend(World &world, Model &model, const char *blank_prefix = "shape")
+        : world_(world)
+        , model_(model)
+        , blank_prefix_(blank_prefix)
+    { }
+
+    ShapeBackend(const ShapeBackend &) = delete;
+    ShapeBackend & operator=(const ShapeBackend &) = delete;
+
+    SordNode * make_uri(const char *uri, std::size_t length)
+    {
+        // uri is not null terminated
+        uri_.assign(uri, length);
+        return checked(sord_new_uri(world_.c_obj(), (const uint8_t *)uri_.c_str()), "sord_new_uri");
+    }
+
+    SordNode * make_blank()
+    {
+        static std::atomic<unsigned long long> next_id(0);
+        static const std::string tag(process_tag());
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.24s%s%llx", blank_prefix_, tag.c_str(), next_id++);
+        return checked(sord_new_blank(world_.c_obj(), (const uint8_t *)buffer), "sord_new_blank");
+    }
+
+    SordNode * make_double(double value)
+    {
+        SerdNode val = serd_node_new_decimal(value, 7);
+        const SerdNode type = serd_node_from_string(SERD_URI, (const uint8_t *)SORD_NS_XSD "double");
+        SordNode *node = sord_node_from_serd_node(world_.c_obj(), world_.prefixes().c_obj(), &val, &type, NULL);
+        serd_node_free(&val);
+        return checked(node, "sord_node_from_serd_node");
+    }
+
+    void free(SordNode *node)
+    {
+        sord_node_free(world_.c_obj(), node);
+    }
+
+    bool add(SordNode *subject, SordNode *predicate, SordNode *object)
+    {
+        SordQuad quad = { subject, predicate, object, NULL };
+        return sord_add(model_.c_obj(), quad);
+    }
+
+private:
+
+    static std::string process_tag()
+    {
+        char tag[Arvida::RDF::BlankTag::length];
+        Arvida::RDF::BlankTag::format(Arvida::RDF::BlankTag::random_seed(), tag);
+        return std::string(tag, sizeof(tag));
+    }
+
+    static SordNode * checked(SordNode *node, const char *function)
+    {
+        if (!node)
+            throw std::runtime_error(std::string(function) + " returned no node");
+        return node;
+    }
+
+    World &world_;
+    Model &model_;
+    const char *blank_prefix_;
+    std::string uri_;
+};
+
+template <class ShapeT>
+using ShapeEmitter = RDFShape::Emitter<ShapeT, ShapeBackend>;
+
+} // namespace Sord
+
+#endif /* SORDMM_SHAPE_HPP_INCLUDED */
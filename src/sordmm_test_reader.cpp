@@ -15,6 +15,7 @@
 
 #define SEORD_LIB
 #include "sord/sordmm.hpp"
+#include "sordmm_bulk_loader.hpp"
 #include "serd/serd.h"
 #include "Profiler.h"
 
@@ -73,7 +74,8 @@ int main(int argc, char *argv[])
 
     start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
 
-    model.load_file(world.prefixes().c_obj(), SERD_TURTLE, fileName, "");
+    BulkLoader loader(model);
+    loader.load_file(world.prefixes().c_obj(), SERD_TURTLE, fileName, "");
 
     finish = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
 
@@ -14,6 +14,8 @@
 
 #include "sord/sordmm.hpp"
 #include "serd/serd.h"
+#include "sordmm_shape.hpp"
+#include "pose_shape.hpp"
 #include "Profiler.h"
 
 #define RDF(x) "http://www.w3.org/1999/02/22-rdf-syntax-ns#" x
@@ -24,19 +26,6 @@
 #define MEA(x) "http://vocab.arvida.de/2014/03/mea/vocab#" x
 #define XSD(x) "http://www.w3.org/2001/XMLSchema#" x
 
-inline Sord::Node double_node(Sord::World &world, double d)
-{
-    const SerdNode val = serd_node_new_decimal(d, 7);
-    const SerdNode type = serd_node_from_string(
-        SERD_URI, (const uint8_t *)SORD_NS_XSD "double");
-
-    return Sord::Node(
-        world,
-        sord_node_from_serd_node(
-            world.c_obj(), world.prefixes().c_obj(), &val, &type, NULL),
-        false);
-}
-
 int main(int argc, char *argv[])
 {
     using namespace Sord;
@@ -64,139 +53,15 @@ int main(int argc, char *argv[])
 
     MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, finish, elapsed;
 
+    // constant nodes of the pose are created once by the emitter
+    ShapeEmitter<PoseShape::Pose> pose_emitter(world, model);
+    const double values[PoseShape::NUM_VALUES] = { 1, 2, 3, 1, 1, 1, 1 };
+
     start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
 
     for (int i = 0; i < num; ++i)
     {
-        const std::string uuid_url = "http://test.arvida.de/UUID" + std::to_string(i);
-
-        model.add_statement(
-            URI(world, uuid_url),
-            URI(world, RDF("type")),
-            URI(world, SPATIAL("SpatialRelationship")));
-
-        {
-            Node n1 = Node::blank_id(world);
-
-            model.add_statement(
-                URI(world, uuid_url),
-                URI(world, SPATIAL("sourceCoordinateSystem")),
-                n1);
-
-            model.add_statement(
-                n1,
-                URI(world, RDF("type")),
-                URI(world, MATHS("LeftHandedCartesianCoordinateSystem3D")));
-        }
-
-        {
-            Node n1 = Node::blank_id(world);
-
-            model.add_statement(
-                URI(world, uuid_url),
-                URI(world, SPATIAL("targetCoordinateSystem")),
-                n1);
-
-            model.add_statement(
-                n1,
-                URI(world, RDF("type")),
-                URI(world, MATHS("RightHandedCartesianCoordinateSystem2D")));
-        }
-
-        URI xsd_double(world, XSD("double"));
-
-        {
-
-            // translation
-            Node n1 = Node::blank_id(world);
-            Node n2 = Node::blank_id(world);
-
-            model.add_statement(
-                URI(world, uuid_url),
-                URI(world, SPATIAL("translation")),
-                n1);
-
-            model.add_statement(
-                n1,
-                URI(world, RDF("type")),
-                URI(world, SPATIAL("Translation3D")));
-
-            model.add_statement(
-                n1,
-                URI(world, VOM("quantityValue")),
-                n2);
-
-            model.add_statement(
-                n2,
-                URI(world, RDF("type")),
-                URI(world, MATHS("Vector3D")));
-
-            model.add_statement(
-                n2,
-                URI(world, MATHS("x")),
-                double_node(world, 1));
-
-            model.add_statement(
-                n2,
-                URI(world, MATHS("y")),
-                double_node(world, 2));
-
-            model.add_statement(
-                n2,
-                URI(world, MATHS("z")),
-                double_node(world, 3));
-        }
-
-        {
-            // rotation
-
-            Node n1 = Node::blank_id(world);
-            Node n2 = Node::blank_id(world);
-
-            model.add_statement(
-                URI(world, uuid_url),
-                URI(world, SPATIAL("rotation")),
-                n1);
-
-            model.add_statement(
-                n1,
-                URI(world, RDF("type")),
-                URI(world, SPATIAL("Rotation3D")));
-
-            model.add_statement(
-                n1,
-                URI(world, VOM("quantityValue")),
-                n2);
-
-            model.add_statement(
-                n2,
-                URI(world, RDF("type")),
-                URI(world, MATHS("Quaternion")));
-
-            model.add_statement(
-                n2,
-                URI(world, RDF("type")),
-                URI(world, MATHS("Vector4D")));
-
-            model.add_statement(
-                n2,
-                URI(world, MATHS("x")),
-                double_node(world, 1));
-
-            model.add_statement(n2,
-                                URI(world, MATHS("y")),
-                                double_node(world, 1));
-
-            model.add_statement(
-                n2,
-                URI(world, MATHS("z")),
-                double_node(world, 1));
-
-            model.add_statement(
-                n2,
-                URI(world, MATHS("w")),
-                double_node(world, 1));
-        }
+        pose_emitter.emit("http://test.arvida.de/UUID" + std::to_string(i), values);
     }
 
     finish = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
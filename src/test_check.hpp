@@ -0,0 +1,42 @@
+/*
+ * test_check.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef TEST_CHECK_HPP_INCLUDED
+#define TEST_CHECK_HPP_INCLUDED
+
+#include <iostream>
+
+/**
+ * Failure counting shared by the test programs. CHECK reports a failed
+ * expression and continues, main returns test_exit_status().
+ */
+
+inline int & test_failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(expr)                                                               \
+    do                                                                            \
+    {                                                                             \
+        if (!(expr))                                                              \
+        {                                                                         \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": failed: " #expr << std::endl; \
+            ++test_failures();                                                    \
+        }                                                                         \
+    } while (0)
+
+/** 0 when nothing failed, otherwise reports the number of failed what */
+inline int test_exit_status(const char *what = "checks")
+{
+    if (test_failures())
+        std::cerr << test_failures() << " " << what << " failed" << std::endl;
+    return test_failures() ? 1 : 0;
+}
+
+#endif /* TEST_CHECK_HPP_INCLUDED */
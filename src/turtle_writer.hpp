@@ -0,0 +1,280 @@
+/*
+ * turtle_writer.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef RDW_TURTLE_WRITER_HPP_INCLUDED
+#define RDW_TURTLE_WRITER_HPP_INCLUDED
+
+#include "ntriples_writer.hpp"
+#include <string>
+#include <vector>
+
+namespace Redland
+{
+
+/**
+ * Streaming Turtle writer.
+ *
+ * Consecutive statements with the same subject are written as one
+ * subject group, using ';' for a new predicate and ',' for a repeated
+ * predicate. Only the current subject and predicate are kept, so memory
+ * does not depend on the size of the output. Prefixes are declared when
+ * they are used the first time. Unsorted input is still written as valid
+ * Turtle, just with more and shorter subject groups.
+ */
+class TurtleWriter : private NTriplesWriter
+{
+public:
+
+    TurtleWriter(FILE *handle, const Namespaces &namespaces)
+        : NTriplesWriter(handle)
+    {
+        init(namespaces);
+    }
+
+    TurtleWriter(std::ostream &out, const Namespaces &namespaces)
+        : NTriplesWriter(out)
+    {
+        init(namespaces);
+    }
+
+    TurtleWriter(std::string &dest, const Namespaces &namespaces)
+        : NTriplesWriter(dest)
+    {
+        init(namespaces);
+    }
+
+    ~TurtleWriter()
+    {
+        finish();
+    }
+
+    using NTriplesWriter::good;
+
+    /** Number of subject groups written, equals number of subjects for clustered input */
+    std::size_t num_subject_groups() const { return num_groups_; }
+
+    void write_statement(librdf_statement *statement)
+    {
+        librdf_node *subject = librdf_statement_get_subject(statement);
+        librdf_node *predicate = librdf_statement_get_predicate(statement);
+        librdf_node *object = librdf_statement_get_object(statement);
+
+        declare_prefixes(subject, predicate, object);
+
+        if (subject_.is_valid() && librdf_node_equals(subject_.c_obj(), subject))
+        {
+            if (librdf_node_equals(predicate_.c_obj(), predicate))
+            {
+                append(" ,\n        ", 11);
+                write_term(object);
+                return;
+            }
+            append(" ;\n    ", 7);
+        }
+        else
+        {
+            end_group();
+            subject_ = Node(librdf_new_node_from_node(subject));
+            write_term(subject);
+            put(' ');
+            num_groups_++;
+        }
+        predicate_ = Node(librdf_new_node_from_node(predicate));
+        write_predicate(predicate);
+        put(' ');
+        write_term(object);
+    }
+
+    void write_statement(const Statement &statement)
+    {
+        write_statement(statement.c_obj());
+    }
+
+    /**
+     * Write all remaining statements of the stream, returns their number.
+     * Contexts are ignored.
+     */
+    std::size_t write(Stream &stream)
+    {
+        std::size_t count = 0;
+        for (; stream.is_valid() && !stream.is_end(); stream.next())
+        {
+            if (librdf_statement *statement = librdf_stream_get_object(stream.c_obj()))
+            {
+                write_statement(statement);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    std::size_t write(const Model &model)
+    {
+        Stream stream(model.as_stream());
+        return write(stream);
+    }
+
+    /**
+     * Terminate the open subject group and flush the output.
+     */
+    bool finish()
+    {
+        end_group();
+        return flush();
+    }
+
+private:
+
+    void init(const Namespaces &namespaces)
+    {
+        num_groups_ = 0;
+        namespaces_ = namespaces;
+        declared_.assign(namespaces_.num_prefixes(), 0);
+    }
+
+    void end_group()
+    {
+        if (subject_.is_valid())
+        {
+            append(" .\n", 3);
+            subject_ = Node();
+            predicate_ = Node();
+        }
+    }
+
+    static StringRef uri_string(librdf_uri *uri)
+    {
+        size_t length = 0;
+        const unsigned char *s = librdf_uri_as_counted_string(uri, &length);
+        return StringRef(reinterpret_cast<const char *>(s), length);
+    }
+
+    bool declare_prefix(librdf_uri *uri)
+    {
+        std::size_t offset = 0;
+        const std::size_t index = namespaces_.find_compact(uri_string(uri), offset);
+        if (index == Namespaces::npos || declared_[index])
+            return false;
+
+        // a prefix declaration may not appear inside a subject group
+        end_group();
+        const StringRef name = namespaces_.prefix_name(index);
+        const StringRef prefix_uri = namespaces_.prefix_uri(index);
+        append("@prefix ", 8);
+        append(name.data(), name.size());
+        append(": ", 2);
+        write_iri(reinterpret_cast<const unsigned char *>(prefix_uri.data()), prefix_uri.size());
+        append(" .\n", 3);
+        declared_[index] = 1;
+        return true;
+    }
+
+    bool declare_node_prefix(librdf_node *node)
+    {
+        if (librdf_node_is_resource(node))
+            return declare_prefix(librdf_node_get_uri(node));
+        if (librdf_node_is_literal(node))
+        {
+            if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                return declare_prefix(datatype);
+        }
+        return false;
+    }
+
+    /** True when a new prefix was declared, which closes the subject group */
+    bool declare_prefixes(librdf_node *subject, librdf_node *predicate, librdf_node *object)
+    {
+        bool declared = declare_node_prefix(subject);
+        declared = declare_node_prefix(predicate) || declared;
+        declared = declare_node_prefix(object) || declared;
+        return declared;
+    }
+
+    void write_uri(librdf_uri *uri)
+    {
+        const StringRef iri = uri_string(uri);
+        StringRef prefix, local;
+        if (!namespaces_.compact(iri, prefix, local))
+        {
+            write_iri(reinterpret_cast<const unsigned char *>(iri.data()), iri.size());
+            return;
+        }
+        append(prefix.data(), prefix.size());
+        put(':');
+        append(local.data(), local.size());
+    }
+
+    void write_predicate(librdf_node *predicate)
+    {
+        static const char rdf_type[] = "http://www.w3.org/1999/02/22-rdf-syntax-ns#type";
+        size_t length = 0;
+        const unsigned char *s = librdf_uri_as_counted_string(librdf_node_get_uri(predicate), &length);
+        if (length == sizeof(rdf_type) - 1 && std::memcmp(s, rdf_type, length) == 0)
+            put('a');
+        else
+            write_uri(librdf_node_get_uri(predicate));
+    }
+
+    void write_term(librdf_node *node)
+    {
+        switch (librdf_node_get_type(node))
+        {
+            case LIBRDF_NODE_TYPE_RESOURCE:
+                write_uri(librdf_node_get_uri(node));
+                break;
+            case LIBRDF_NODE_TYPE_LITERAL:
+            {
+                size_t length = 0;
+                const unsigned char *s = librdf_node_get_literal_value_as_counted_string(node, &length);
+                put('"');
+                write_escaped(s, length, false);
+                put('"');
+                if (const char *language = librdf_node_get_literal_value_language(node))
+                {
+                    put('@');
+                    append(language, std::strlen(language));
+                }
+                else if (librdf_uri *datatype = librdf_node_get_literal_value_datatype_uri(node))
+                {
+                    append("^^", 2);
+                    write_uri(datatype);
+                }
+                break;
+            }
+            default:
+                write_node(node);
+                break;
+        }
+    }
+
+    Namespaces namespaces_;
+    std::vector<char> declared_;
+    Node subject_;
+    Node predicate_;
+    std::size_t num_groups_;
+};
+
+inline bool write_turtle(FILE *fd, const Model &model, const Namespaces &namespaces)
+{
+    TurtleWriter writer(fd, namespaces);
+    writer.write(model);
+    return writer.finish();
+}
+
+inline bool write_turtle(const char *filename, const Model &model, const Namespaces &namespaces)
+{
+    FILE *fd = fopen(filename, "wb");
+    if (!fd)
+        return false;
+    bool result = write_turtle(fd, model, namespaces);
+    fclose(fd);
+    return result;
+}
+
+} // namespace Redland
+
+#endif /* RDW_TURTLE_WRITER_HPP_INCLUDED */